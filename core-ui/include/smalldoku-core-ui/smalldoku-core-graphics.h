@@ -2,9 +2,41 @@
 
 #include <smalldoku/smalldoku.h>
 
+/**
+ * The size of a single cell in pixels, grids above 9x9 shrink their cells to stay within 720 pixels.
+ */
+#define SMALLDOKU_CORE_GRAPHICS_CELL_SIZE (SMALLDOKU_GRID_WIDTH <= 9 ? 80 : 720 / SMALLDOKU_GRID_WIDTH)
+
 struct smalldoku_graphics;
 typedef struct smalldoku_graphics smalldoku_graphics_t;
 
+/**
+ * Highlighting of a cell, only applies to SMALLDOKU_USER_CELL cells.
+ */
+enum smalldoku_cell_mark {
+    /**
+     * The cell is not highlighted
+     */
+    SMALLDOKU_MARK_NONE,
+
+    /**
+     * The cell is selected for input
+     */
+    SMALLDOKU_MARK_SELECTED,
+
+    /**
+     * The user value of the cell has been checked and is correct
+     */
+    SMALLDOKU_MARK_CORRECT,
+
+    /**
+     * The user value of the cell has been checked and is wrong
+     */
+    SMALLDOKU_MARK_WRONG
+};
+
+typedef enum smalldoku_cell_mark smalldoku_cell_mark_t;
+
 /**
  * Function to query the width and height of the canvas.
  *
@@ -109,12 +141,14 @@ struct smalldoku_graphics {
  *
  * @param graphics the graphics context to operate on
  * @param grid the grid to draw
+ * @param marks the smalldoku_cell_mark_t of every cell in row major order
  * @param x pointer to write the x position of the grid to
  * @param y pointer to write the y position of the grid to
  */
 void smalldoku_core_graphics_draw_grid_centered(
         smalldoku_graphics_t *graphics,
         SMALLDOKU_GRID(grid),
+        const smalldoku_uint8_t *marks,
         smalldoku_uint32_t *x,
         smalldoku_uint32_t *y
 );
@@ -126,12 +160,29 @@ void smalldoku_core_graphics_draw_grid_centered(
  * @param x the x coordinate to start drawing at
  * @param y the y coordinate to start drawing at
  * @param grid the grid to draw
+ * @param marks the smalldoku_cell_mark_t of every cell in row major order
  */
 void smalldoku_core_graphics_draw_grid(
         smalldoku_graphics_t *graphics,
         smalldoku_uint32_t x,
         smalldoku_uint32_t y,
-        SMALLDOKU_GRID(grid)
+        SMALLDOKU_GRID(grid),
+        const smalldoku_uint8_t *marks
+);
+
+/**
+ * Draws a progress bar along the top edge of a grid.
+ *
+ * @param graphics the graphics context to operate on
+ * @param x the x coordinate the grid has been drawn at
+ * @param y the y coordinate the grid has been drawn at
+ * @param progress the progress in percent
+ */
+void smalldoku_core_graphics_draw_progress(
+        smalldoku_graphics_t *graphics,
+        smalldoku_uint32_t x,
+        smalldoku_uint32_t y,
+        smalldoku_uint8_t progress
 );
 
 /**
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <smalldoku/smalldoku.h>
+#include <smalldoku/smalldoku-bank.h>
+#include <smalldoku/smalldoku-generator.h>
+#include <smalldoku/smalldoku-grader.h>
+#include <smalldoku/smalldoku-rng.h>
 
 #include "smalldoku-core-ui/smalldoku-core-graphics.h"
 
@@ -14,15 +18,45 @@ struct smalldoku_core_ui {
     smalldoku_graphics_t *graphics;
 
     /**
-     * The function to use for generating random numbers.
+     * The random number generator all games are generated with.
      */
-    smalldoku_rng_fn rng;
+    smalldoku_rng_t rng;
+
+    /**
+     * The bank to pick games from, or NULL to generate every game.
+     */
+    const smalldoku_bank_t *bank;
+
+    /**
+     * The hardest technique generated games may need.
+     */
+    smalldoku_technique_t max_technique;
+
+    /**
+     * The generator producing the next game, published into the grid once finished.
+     */
+    smalldoku_generator_t generator;
+
+    /**
+     * Whether the generator is still producing a game.
+     */
+    smalldoku_uint8_t generating;
 
     /**
      * The smalldoku grid instance.
      */
     SMALLDOKU_GRID(grid);
 
+    /**
+     * The smalldoku_cell_mark_t of every cell in row major order.
+     */
+    smalldoku_uint8_t marks[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The number typed into the selected cells so far, numbers above 9 are entered digit by digit.
+     */
+    smalldoku_uint8_t input;
+
     /**
      * The current graphics x coordinate of the grid.
      */
@@ -40,18 +74,50 @@ typedef struct smalldoku_core_ui smalldoku_core_ui_t;
  * Creates a new UI state.
  *
  * @param graphics the graphics context to use for drawing
- * @param rng the function to use for generating random numbers
+ * @param seed the seed of the random number generator, the same seed produces the same sequence of games
  * @return the created UI state
  */
-smalldoku_core_ui_t smalldoku_core_ui_new(smalldoku_graphics_t *graphics, smalldoku_rng_fn rng);
+smalldoku_core_ui_t smalldoku_core_ui_new(smalldoku_graphics_t *graphics, smalldoku_uint64_t seed);
+
+/**
+ * Sets the bank new games are picked from.
+ *
+ * @param ui the UI state to set the bank of
+ * @param bank the opened bank, must outlive the UI state, or NULL to generate every game
+ */
+void smalldoku_core_ui_set_bank(smalldoku_core_ui_t *ui, const smalldoku_bank_t *bank);
+
+/**
+ * Sets the difficulty of the games generated from now on.
+ *
+ * @param ui the UI state to set the difficulty of
+ * @param max_technique the hardest technique generated games may need, or SMALLDOKU_TECHNIQUE_NONE for any game
+ *                      with a unique solution
+ */
+void smalldoku_core_ui_set_difficulty(smalldoku_core_ui_t *ui, smalldoku_technique_t max_technique);
 
 /**
  * Begins a new game for an UI state.
  *
+ * If a non empty bank has been set the game is picked from it immediately. Otherwise the game is generated by
+ * smalldoku_core_ui_generate, until it is finished the previous grid stays visible.
+ *
  * @param ui the UI state to begin a new game on
  */
 void smalldoku_core_ui_begin_game(smalldoku_core_ui_t *ui);
 
+/**
+ * Continues generating the game begun by smalldoku_core_ui_begin_game.
+ *
+ * Meant to be called by the event loop whenever no events are pending, see smalldoku_generator_step for how
+ * work is measured.
+ *
+ * @param ui the UI state to generate the game for
+ * @param max_work the amount of work after which the call returns
+ * @return 1 if more work is pending, 0 if no game is being generated
+ */
+smalldoku_uint8_t smalldoku_core_ui_generate(smalldoku_core_ui_t *ui, smalldoku_uint64_t max_work);
+
 /**
  * Draws the UI state centered in the graphics context.
  *
@@ -2,13 +2,14 @@
 
 #define RGB(r, g, b) (0xFF000000 | ((r & 0xFF) << 16) | ((g & 0xFF) << 8) | (b & 0xFF))
 
-const static smalldoku_uint32_t SCALE = 80;
+const static smalldoku_uint32_t SCALE = SMALLDOKU_CORE_GRAPHICS_CELL_SIZE;
 const static smalldoku_uint32_t GRID_WIDTH = SCALE * SMALLDOKU_GRID_WIDTH;
 const static smalldoku_uint32_t GRID_HEIGHT = SCALE * SMALLDOKU_GRID_HEIGHT;
 
 void smalldoku_core_graphics_draw_grid_centered(
         smalldoku_graphics_t *graphics,
         SMALLDOKU_GRID(grid),
+        const smalldoku_uint8_t *marks,
         smalldoku_uint32_t *x,
         smalldoku_uint32_t *y
 ) {
@@ -19,14 +20,15 @@ void smalldoku_core_graphics_draw_grid_centered(
     *x = (graphics_width / 2) - (GRID_WIDTH / 2);
     *y = (graphics_height / 2) - (GRID_HEIGHT / 2);
 
-    smalldoku_core_graphics_draw_grid(graphics, *x, *y, grid);
+    smalldoku_core_graphics_draw_grid(graphics, *x, *y, grid, marks);
 }
 
 void smalldoku_core_graphics_draw_grid(
         smalldoku_graphics_t *graphics,
         smalldoku_uint32_t x,
         smalldoku_uint32_t y,
-        SMALLDOKU_GRID(grid)
+        SMALLDOKU_GRID(grid),
+        const smalldoku_uint8_t *marks
 ) {
     graphics->set_fill(graphics, RGB(0xFF, 0xFF, 0xFF));
     graphics->draw_rect(graphics, x, y, GRID_WIDTH, GRID_HEIGHT);
@@ -40,16 +42,16 @@ void smalldoku_core_graphics_draw_grid(
             if (grid[row][col].type == SMALLDOKU_GENERATED_CELL) {
                 graphics->set_fill(graphics, RGB(0xCC, 0xCC, 0xCC));
             } else {
-                switch ((smalldoku_uint64_t) grid[row][col].user_data) {
-                    case 0x1:
+                switch (marks[row * SMALLDOKU_GRID_WIDTH + col]) {
+                    case SMALLDOKU_MARK_SELECTED:
                         graphics->set_fill(graphics, RGB(0xCC, 0xCC, 0x00));
                         break;
 
-                    case 0x2:
+                    case SMALLDOKU_MARK_CORRECT:
                         graphics->set_fill(graphics, RGB(0x55, 0xAA, 0x55));
                         break;
 
-                    case 0x3:
+                    case SMALLDOKU_MARK_WRONG:
                         graphics->set_fill(graphics, RGB(0xAA, 0x55, 0x55));
                         break;
 
@@ -62,7 +64,14 @@ void smalldoku_core_graphics_draw_grid(
             graphics->draw_rect(graphics, cell_rect_x, cell_rect_y, SCALE, SCALE);
 
             if (cell_value != 0) {
-                char display_text[2] = {(char) ('0' + cell_value), '\0'};
+                /* Numbers of grids above 9x9 take up to two digits */
+                char display_text[3] = {0};
+                if (cell_value < 10) {
+                    display_text[0] = (char) ('0' + cell_value);
+                } else {
+                    display_text[0] = (char) ('0' + cell_value / 10);
+                    display_text[1] = (char) ('0' + cell_value % 10);
+                }
 
                 smalldoku_uint32_t text_width;
                 smalldoku_uint32_t text_height;
@@ -100,6 +109,19 @@ void smalldoku_core_graphics_draw_grid(
     }
 }
 
+void smalldoku_core_graphics_draw_progress(
+        smalldoku_graphics_t *graphics,
+        smalldoku_uint32_t x,
+        smalldoku_uint32_t y,
+        smalldoku_uint8_t progress
+) {
+    graphics->set_fill(graphics, RGB(0xCC, 0xCC, 0xCC));
+    graphics->draw_rect(graphics, x, y - 14, GRID_WIDTH, 8);
+
+    graphics->set_fill(graphics, RGB(0x55, 0xAA, 0x55));
+    graphics->draw_rect(graphics, x, y - 14, GRID_WIDTH * progress / 100, 8);
+}
+
 smalldoku_uint32_t smalldoku_core_graphics_get_grid_width(smalldoku_graphics_t *graphics) {
     (void) graphics;
     return GRID_WIDTH;
@@ -1,40 +1,131 @@
 #include "smalldoku-core-ui/smalldoku-core-ui.h"
 
-smalldoku_core_ui_t smalldoku_core_ui_new(smalldoku_graphics_t *graphics, smalldoku_rng_fn rng) {
+
+/**
+ * The amount of generated cells a new game starts with, about 37% of the cells (30 with 9x9 grids).
+ */
+#define GAME_CLUE_COUNT (SMALLDOKU_CELL_COUNT * 10 / 27)
+
+/**
+ * The hardest technique generated games may need unless set otherwise, every game can be solved without guessing.
+ */
+#define GAME_MAX_TECHNIQUE SMALLDOKU_TECHNIQUE_HIDDEN_QUAD
+
+/**
+ * Solver used for generating games, shared by all UI states as it is too large for small stacks.
+ */
+static smalldoku_solver_t generator_solver;
+
+/**
+ * Removes the highlighting from all cells.
+ *
+ * @param ui the UI state to clear the marks of
+ */
+static void clear_marks(smalldoku_core_ui_t *ui) {
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        ui->marks[i] = SMALLDOKU_MARK_NONE;
+    }
+}
+
+smalldoku_core_ui_t smalldoku_core_ui_new(smalldoku_graphics_t *graphics, smalldoku_uint64_t seed) {
     smalldoku_core_ui_t ui;
 
+    smalldoku_solver_config_t config = {
+            SMALLDOKU_SOLVER_BITBOARD,
+            SMALLDOKU_BRANCH_MOST_CONSTRAINED,
+            SMALLDOKU_PROPAGATE_SINGLES,
+            0
+    };
+    smalldoku_solver_init(&generator_solver, &config);
+
     ui.graphics = graphics;
-    ui.rng = rng;
+    ui.bank = 0;
+    ui.max_technique = GAME_MAX_TECHNIQUE;
+    smalldoku_rng_seed(&ui.rng, seed);
+    ui.generating = 0;
     smalldoku_init(ui.grid);
+    clear_marks(&ui);
+    ui.input = 0;
     ui.grid_x = 0;
     ui.grid_y = 0;
 
     return ui;
 }
 
+void smalldoku_core_ui_set_bank(smalldoku_core_ui_t *ui, const smalldoku_bank_t *bank) {
+    ui->bank = bank;
+}
+
+void smalldoku_core_ui_set_difficulty(smalldoku_core_ui_t *ui, smalldoku_technique_t max_technique) {
+    ui->max_technique = max_technique;
+}
+
 void smalldoku_core_ui_begin_game(smalldoku_core_ui_t *ui) {
-    smalldoku_init(ui->grid);
-    smalldoku_fill_grid(ui->grid, ui->rng);
-    smalldoku_hammer_grid(ui->grid, 5, ui->rng);
+    if (ui->bank) {
+        const smalldoku_bank_entry_t *entry = smalldoku_bank_pick(ui->bank, 0, SMALLDOKU_CELL_COUNT, &ui->rng);
+
+        if (entry) {
+            smalldoku_bank_entry_to_grid(entry, ui->grid);
+            clear_marks(ui);
+            ui->generating = 0;
+            ui->graphics->request_redraw(ui->graphics);
+            return;
+        }
+    }
+
+    smalldoku_generator_start(&ui->generator, &generator_solver, GAME_CLUE_COUNT, ui->max_technique, &ui->rng);
+    ui->generating = 1;
     ui->graphics->request_redraw(ui->graphics);
 }
 
+smalldoku_uint8_t smalldoku_core_ui_generate(smalldoku_core_ui_t *ui, smalldoku_uint64_t max_work) {
+    if (!ui->generating) {
+        return 0;
+    }
+
+    smalldoku_uint8_t progress = smalldoku_generator_progress(&ui->generator);
+
+    if (smalldoku_generator_step(&ui->generator, max_work)) {
+        smalldoku_generator_get_grid(&ui->generator, ui->grid);
+        clear_marks(ui);
+        ui->generating = 0;
+        ui->graphics->request_redraw(ui->graphics);
+        return 0;
+    }
+
+    if (smalldoku_generator_progress(&ui->generator) != progress) {
+        ui->graphics->request_redraw(ui->graphics);
+    }
+
+    return 1;
+}
+
 void smalldoku_core_ui_draw_centered(smalldoku_core_ui_t *ui) {
-    smalldoku_core_graphics_draw_grid_centered(ui->graphics, ui->grid, &ui->grid_x, &ui->grid_y);
+    smalldoku_core_graphics_draw_grid_centered(ui->graphics, ui->grid, ui->marks, &ui->grid_x, &ui->grid_y);
+
+    if (ui->generating) {
+        smalldoku_core_graphics_draw_progress(
+                ui->graphics,
+                ui->grid_x,
+                ui->grid_y,
+                smalldoku_generator_progress(&ui->generator)
+        );
+    }
 }
 
 void smalldoku_core_ui_draw(smalldoku_core_ui_t *ui, smalldoku_uint32_t x, smalldoku_uint32_t y) {
     ui->grid_x = x;
     ui->grid_y = y;
-    smalldoku_core_graphics_draw_grid(ui->graphics, x, y, ui->grid);
+    smalldoku_core_graphics_draw_grid(ui->graphics, x, y, ui->grid, ui->marks);
+
+    if (ui->generating) {
+        smalldoku_core_graphics_draw_progress(ui->graphics, x, y, smalldoku_generator_progress(&ui->generator));
+    }
 }
 
 void smalldoku_core_ui_click(smalldoku_core_ui_t *ui, smalldoku_uint32_t x, smalldoku_uint32_t y) {
-    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
-        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-            ui->grid[row][col].user_data = 0x0;
-        }
-    }
+    clear_marks(ui);
+    ui->input = 0;
 
     smalldoku_uint32_t grid_click_x = x - ui->grid_x;
     smalldoku_uint32_t grid_click_y = y - ui->grid_y;
@@ -50,7 +141,7 @@ void smalldoku_core_ui_click(smalldoku_core_ui_t *ui, smalldoku_uint32_t x, smal
             &col
     )) {
         if (ui->grid[row][col].type == SMALLDOKU_USER_CELL) {
-            ui->grid[row][col].user_data = (void *) 0x1;
+            ui->marks[row * SMALLDOKU_GRID_WIDTH + col] = SMALLDOKU_MARK_SELECTED;
         }
     }
 
@@ -69,9 +160,9 @@ void smalldoku_core_ui_key(smalldoku_core_ui_t *ui, char key) {
                 for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
                     if (ui->grid[row][col].type == SMALLDOKU_USER_CELL) {
                         if(ui->grid[row][col].user_value == ui->grid[row][col].value) {
-                            ui->grid[row][col].user_data = (void *) 0x2;
+                            ui->marks[row * SMALLDOKU_GRID_WIDTH + col] = SMALLDOKU_MARK_CORRECT;
                         } else {
-                            ui->grid[row][col].user_data = (void *) 0x3;
+                            ui->marks[row * SMALLDOKU_GRID_WIDTH + col] = SMALLDOKU_MARK_WRONG;
                         }
                     }
                 }
@@ -83,12 +174,21 @@ void smalldoku_core_ui_key(smalldoku_core_ui_t *ui, char key) {
 
         default: {
             if (key >= '0' && key <= '9') {
-                smalldoku_uint8_t number = key - '0';
+                smalldoku_uint8_t digit = key - '0';
+
+                /* Wider than the input, as appending a digit to 25 would wrap around in 8 bits */
+                smalldoku_uint16_t number = ui->input * 10 + digit;
+
+                /* Append the digit to the number typed so far if that still is a valid number, otherwise start over */
+                if (number > SMALLDOKU_GRID_WIDTH) {
+                    number = digit <= SMALLDOKU_GRID_WIDTH ? digit : 0;
+                }
+                ui->input = (smalldoku_uint8_t) number;
 
                 for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
                     for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-                        if (ui->grid[row][col].user_data == (void *) 0x1) {
-                            ui->grid[row][col].user_value = number;
+                        if (ui->marks[row * SMALLDOKU_GRID_WIDTH + col] == SMALLDOKU_MARK_SELECTED) {
+                            ui->grid[row][col].user_value = ui->input;
                         }
                     }
                 }
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * Determines which empty cell the solver branches on next.
+ */
+enum smalldoku_branching {
+    /**
+     * Branch on the empty cell with the fewest remaining candidates, the lowest cell index wins ties.
+     */
+    SMALLDOKU_BRANCH_MOST_CONSTRAINED,
+
+    /**
+     * Branch on the next empty cell in row major order.
+     */
+    SMALLDOKU_BRANCH_ROW_MAJOR
+};
+
+typedef enum smalldoku_branching smalldoku_branching_t;
+
+/**
+ * Determines which deductions the solver applies before every branching decision.
+ */
+enum smalldoku_propagation {
+    /**
+     * Repeatedly place naked singles (cells with a single candidate) and hidden singles (numbers with a single
+     * possible cell in a unit) until no more can be found.
+     */
+    SMALLDOKU_PROPAGATE_SINGLES,
+
+    /**
+     * Don't deduce anything, only branch.
+     */
+    SMALLDOKU_PROPAGATE_NONE
+};
+
+typedef enum smalldoku_propagation smalldoku_propagation_t;
+
+/**
+ * Occupancy state of a grid used by the solver and generator.
+ *
+ * Instead of scanning the grid every time a number is tested, the state keeps track of the numbers already placed
+ * in every unit. Testing whether a number can be placed is thereby reduced to ORing the masks of the units of the
+ * cell, which are looked up in the unit tables.
+ */
+struct smalldoku_grid_state {
+    /**
+     * The units of the grid.
+     */
+    const smalldoku_units_t *units;
+
+    /**
+     * The current values of all cells in row major order, 0 for empty cells.
+     */
+    smalldoku_uint8_t cells[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The numbers placed in each unit.
+     */
+    smalldoku_number_mask_t unit_masks[SMALLDOKU_MAX_UNITS];
+
+    /**
+     * The amount of cells which are not empty.
+     */
+    smalldoku_cell_index_t filled;
+};
+
+typedef struct smalldoku_grid_state smalldoku_grid_state_t;
+
+/**
+ * Branching decision of the backtracking solver.
+ */
+struct smalldoku_backtrack_frame {
+    /**
+     * The numbers which have not been tried yet.
+     */
+    smalldoku_number_mask_t remaining;
+
+    /**
+     * The index of the cell branched on.
+     */
+    smalldoku_cell_index_t cell_index;
+
+    /**
+     * The size of the trail before the decision has been made.
+     */
+    smalldoku_cell_index_t trail_mark;
+};
+
+typedef struct smalldoku_backtrack_frame smalldoku_backtrack_frame_t;
+
+/**
+ * Backtracking solver working on the occupancy masks of the grid.
+ *
+ * The search is iterative and never recurses. Every branching decision fills at least one cell, so the decision
+ * stack and the trail are bounded by SMALLDOKU_CELL_COUNT entries each. With 9x9 grids the whole structure, and with
+ * it the worst case memory footprint of a solve, is about 600 bytes, so it can be put on small stacks.
+ */
+struct smalldoku_backtrack {
+    /**
+     * The strategy used for selecting the cell to branch on.
+     */
+    smalldoku_branching_t branching;
+
+    /**
+     * The deductions applied before every branching decision.
+     */
+    smalldoku_propagation_t propagation;
+
+    /**
+     * The grid state being solved.
+     */
+    smalldoku_grid_state_t state;
+
+    /**
+     * The indices of the cells filled during the search, in the order they have been filled.
+     */
+    smalldoku_cell_index_t trail[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The amount of cells on the trail.
+     */
+    smalldoku_cell_index_t trail_size;
+
+    /**
+     * The branching decisions made so far.
+     */
+    smalldoku_backtrack_frame_t frames[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The options controlling the running enumeration.
+     */
+    const smalldoku_solve_options_t *options;
+
+    /**
+     * The number of solutions found by the running enumeration.
+     */
+    smalldoku_uint32_t solve_count;
+
+    /**
+     * The number of search nodes visited by the running enumeration.
+     */
+    smalldoku_uint64_t node_count;
+};
+
+typedef struct smalldoku_backtrack smalldoku_backtrack_t;
+
+/**
+ * Initializes a backtracking solver.
+ *
+ * @param backtrack the solver to initialize
+ * @param units the units of the grid to solve, must outlive the solver
+ * @param branching the strategy to use for selecting the cell to branch on
+ * @param propagation the deductions to apply before every branching decision
+ */
+void smalldoku_backtrack_init(
+        smalldoku_backtrack_t *backtrack,
+        const smalldoku_units_t *units,
+        smalldoku_branching_t branching,
+        smalldoku_propagation_t propagation
+);
+
+/**
+ * Attempts to solve a puzzle using the backtracking solver.
+ *
+ * @param backtrack the initialized solver to solve with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_backtrack_solve_digits(
+        smalldoku_backtrack_t *backtrack,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+);
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-board.h"
+
+/**
+ * The bytes every bank starts with.
+ */
+#define SMALLDOKU_BANK_MAGIC "SDKB"
+
+/**
+ * The version of the bank format described here.
+ */
+#define SMALLDOKU_BANK_VERSION 1
+
+/**
+ * The amount of bits a number of a solution is packed into.
+ */
+#define SMALLDOKU_BANK_NUMBER_BITS (SMALLDOKU_GRID_WIDTH <= 16 ? 4 : 8)
+
+/**
+ * The amount of bytes the packed solution of an entry takes.
+ */
+#define SMALLDOKU_BANK_SOLUTION_BYTES ((SMALLDOKU_CELL_COUNT * SMALLDOKU_BANK_NUMBER_BITS + 7) / 8)
+
+/**
+ * A single puzzle of a bank, 64 bytes for 9x9 grids.
+ *
+ * Banks are read in place, so the layout of this structure is the on disk format. All values are little endian.
+ */
+struct smalldoku_bank_entry {
+    /**
+     * The cells which are part of the puzzle, as a cell set like smalldoku_board_t::given.
+     */
+    smalldoku_uint64_t given[SMALLDOKU_CELL_SET_WORDS];
+
+    /**
+     * The solution in row major order, packed into SMALLDOKU_BANK_NUMBER_BITS per number with the first number in
+     * the lowest bits.
+     */
+    smalldoku_uint8_t solution[SMALLDOKU_BANK_SOLUTION_BYTES];
+
+    /**
+     * The amount of cells which are part of the puzzle.
+     */
+    smalldoku_cell_index_t clue_count;
+
+    /**
+     * The difficulty assigned by the writer of the bank, 0 if unknown.
+     */
+    smalldoku_uint8_t difficulty;
+};
+
+typedef struct smalldoku_bank_entry smalldoku_bank_entry_t;
+
+/**
+ * The start of every bank, followed by the entries sorted by their clue count.
+ *
+ * The entries start at the first multiple of 8 bytes after the header.
+ */
+struct smalldoku_bank_header {
+    /**
+     * SMALLDOKU_BANK_MAGIC without the terminating 0.
+     */
+    smalldoku_uint8_t magic[4];
+
+    /**
+     * The version of the format, SMALLDOKU_BANK_VERSION.
+     */
+    smalldoku_uint16_t version;
+
+    /**
+     * The size of a single entry in bytes.
+     */
+    smalldoku_uint16_t entry_size;
+
+    /**
+     * The width of the grids of the bank.
+     */
+    smalldoku_uint8_t grid_width;
+
+    /**
+     * The height of the grids of the bank.
+     */
+    smalldoku_uint8_t grid_height;
+
+    /**
+     * Always 0.
+     */
+    smalldoku_uint16_t reserved;
+
+    /**
+     * The amount of entries in the bank.
+     */
+    smalldoku_uint32_t entry_count;
+
+    /**
+     * The index of the first entry with a clue count for every clue count, with
+     * clue_index[SMALLDOKU_CELL_COUNT + 1] being entry_count.
+     */
+    smalldoku_uint32_t clue_index[SMALLDOKU_CELL_COUNT + 2];
+};
+
+typedef struct smalldoku_bank_header smalldoku_bank_header_t;
+
+/**
+ * The results of opening a bank.
+ */
+enum smalldoku_bank_status {
+    /**
+     * The bank has been opened.
+     */
+    SMALLDOKU_BANK_OK,
+
+    /**
+     * The data is smaller than the bank it describes.
+     */
+    SMALLDOKU_BANK_TRUNCATED,
+
+    /**
+     * The data is not a bank.
+     */
+    SMALLDOKU_BANK_BAD_MAGIC,
+
+    /**
+     * The bank has been written for another version or grid size.
+     */
+    SMALLDOKU_BANK_UNSUPPORTED,
+
+    /**
+     * The clue count index is inconsistent.
+     */
+    SMALLDOKU_BANK_BAD_INDEX,
+
+    /**
+     * The bank could not be read or written, only reported by platform specific loaders.
+     */
+    SMALLDOKU_BANK_IO_ERROR
+};
+
+typedef enum smalldoku_bank_status smalldoku_bank_status_t;
+
+/**
+ * View of a bank in memory, the memory is never copied.
+ */
+struct smalldoku_bank {
+    /**
+     * The header of the bank.
+     */
+    const smalldoku_bank_header_t *header;
+
+    /**
+     * The entries of the bank.
+     */
+    const smalldoku_bank_entry_t *entries;
+};
+
+typedef struct smalldoku_bank smalldoku_bank_t;
+
+/**
+ * Calculates the size of a bank.
+ *
+ * @param entry_count the amount of entries in the bank
+ * @return the size of the bank in bytes
+ */
+smalldoku_uint64_t smalldoku_bank_size(smalldoku_uint32_t entry_count);
+
+/**
+ * Writes a bank, sorting the entries by their clue count.
+ *
+ * @param buffer the buffer of smalldoku_bank_size(entry_count) bytes to write the bank to, must be 8 byte aligned
+ * @param entries the entries to write
+ * @param entry_count the amount of entries to write
+ */
+void smalldoku_bank_build(void *buffer, const smalldoku_bank_entry_t *entries, smalldoku_uint32_t entry_count);
+
+/**
+ * Opens a bank in memory after validating its header and index.
+ *
+ * @param bank the bank to open
+ * @param data the bank data, must be 8 byte aligned and stay valid while the bank is used
+ * @param size the size of the data in bytes
+ * @return SMALLDOKU_BANK_OK if the bank has been opened, the reason it could not be opened otherwise
+ */
+smalldoku_bank_status_t smalldoku_bank_open(smalldoku_bank_t *bank, const void *data, smalldoku_uint64_t size);
+
+/**
+ * Counts the entries within a range of clue counts.
+ *
+ * @param bank the bank to count in
+ * @param min_clues the smallest clue count to count
+ * @param max_clues the largest clue count to count
+ * @return the amount of entries with a clue count between min_clues and max_clues
+ */
+smalldoku_uint32_t smalldoku_bank_count(
+        const smalldoku_bank_t *bank,
+        smalldoku_cell_index_t min_clues,
+        smalldoku_cell_index_t max_clues
+);
+
+/**
+ * Picks a random entry within a range of clue counts in constant time.
+ *
+ * @param bank the bank to pick from
+ * @param min_clues the smallest clue count to pick
+ * @param max_clues the largest clue count to pick
+ * @param rng the random number generator to use
+ * @return the picked entry, or NULL if there is no entry within the range
+ */
+const smalldoku_bank_entry_t *smalldoku_bank_pick(
+        const smalldoku_bank_t *bank,
+        smalldoku_cell_index_t min_clues,
+        smalldoku_cell_index_t max_clues,
+        smalldoku_rng_t *rng
+);
+
+/**
+ * Packs a puzzle into an entry.
+ *
+ * @param entry the entry to write
+ * @param puzzle the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param solution the SMALLDOKU_CELL_COUNT values of the solution in row major order
+ * @param difficulty the difficulty to store, 0 if unknown
+ */
+void smalldoku_bank_entry_pack(
+        smalldoku_bank_entry_t *entry,
+        const smalldoku_uint8_t *puzzle,
+        const smalldoku_uint8_t *solution,
+        smalldoku_uint8_t difficulty
+);
+
+/**
+ * Unpacks the puzzle of an entry.
+ *
+ * @param entry the entry to unpack
+ * @param puzzle buffer of SMALLDOKU_CELL_COUNT values to write the puzzle to, or NULL to not write it
+ * @param solution buffer of SMALLDOKU_CELL_COUNT values to write the solution to, or NULL to not write it
+ */
+void smalldoku_bank_entry_unpack(
+        const smalldoku_bank_entry_t *entry,
+        smalldoku_uint8_t *puzzle,
+        smalldoku_uint8_t *solution
+);
+
+/**
+ * Unpacks the puzzle of an entry into a grid, cells which are not part of the puzzle become user cells.
+ *
+ * @param entry the entry to unpack
+ * @param grid the grid to write the puzzle to
+ */
+void smalldoku_bank_entry_to_grid(const smalldoku_bank_entry_t *entry, SMALLDOKU_GRID(grid));
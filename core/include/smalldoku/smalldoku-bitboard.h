@@ -0,0 +1,133 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * The amount of 64 bit lanes of a board, the smallest power of two covering all cells.
+ */
+#if SMALLDOKU_CELL_COUNT <= 128
+#define SMALLDOKU_BITBOARD_LANES 2
+#elif SMALLDOKU_CELL_COUNT <= 256
+#define SMALLDOKU_BITBOARD_LANES 4
+#elif SMALLDOKU_CELL_COUNT <= 512
+#define SMALLDOKU_BITBOARD_LANES 8
+#elif SMALLDOKU_CELL_COUNT <= 1024
+#define SMALLDOKU_BITBOARD_LANES 16
+#else
+#error "The bitboard solver only supports grids with up to 1024 cells"
+#endif
+
+/**
+ * A set of cells, the cell with the row major index n is represented by bit (n % 64) of lane (n / 64).
+ *
+ * With 9x9 grids the type is a 128 bit vector so that whole boards fit into a single SSE register, larger grids use
+ * wider vectors which the compiler splits into as many registers as needed.
+ */
+typedef smalldoku_uint64_t smalldoku_bitboard_t __attribute__((vector_size(SMALLDOKU_BITBOARD_LANES * 8)));
+
+/**
+ * Candidate state of a grid for the bitboard solver.
+ */
+struct smalldoku_bitboard_state {
+    /**
+     * For every number, the cells the number may still be placed into or has been placed into.
+     */
+    smalldoku_bitboard_t candidates[SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * The cells which have been filled.
+     */
+    smalldoku_bitboard_t solved;
+};
+
+typedef struct smalldoku_bitboard_state smalldoku_bitboard_state_t;
+
+/**
+ * Branching decision of the bitboard solver.
+ */
+struct smalldoku_bitboard_frame {
+    /**
+     * The state before the decision has been made.
+     */
+    smalldoku_bitboard_state_t state;
+
+    /**
+     * The numbers which have not been tried yet.
+     */
+    smalldoku_number_mask_t remaining;
+
+    /**
+     * The index of the cell branched on.
+     */
+    smalldoku_cell_index_t cell_index;
+};
+
+typedef struct smalldoku_bitboard_frame smalldoku_bitboard_frame_t;
+
+/**
+ * Solver keeping one board per number and deducing singles for all cells at once using vector operations.
+ *
+ * The structure holds the lookup tables and the decision stack (about 16KiB with 9x9 grids, about 150KiB with 16x16
+ * grids), so it should not be put on small stacks.
+ */
+struct smalldoku_bitboard_solver {
+    /**
+     * For every cell, the other cells sharing a unit with it.
+     */
+    smalldoku_bitboard_t peers[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The cells of every unit.
+     */
+    smalldoku_bitboard_t units[SMALLDOKU_MAX_UNITS];
+
+    /**
+     * The amount of units.
+     */
+    smalldoku_uint8_t unit_count;
+
+    /**
+     * All cells of the grid.
+     */
+    smalldoku_bitboard_t all;
+
+    /**
+     * The branching decisions made so far.
+     */
+    smalldoku_bitboard_frame_t frames[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * Buffer the solutions are written to in row major order.
+     */
+    smalldoku_uint8_t cells[SMALLDOKU_CELL_COUNT];
+};
+
+typedef struct smalldoku_bitboard_solver smalldoku_bitboard_solver_t;
+
+/**
+ * Computes the lookup tables of the solver.
+ *
+ * This only needs to be done once, the solver can be reused for any number of solves.
+ *
+ * @param solver the solver to initialize
+ * @param units the units of the grid to solve
+ */
+void smalldoku_bitboard_init(smalldoku_bitboard_solver_t *solver, const smalldoku_units_t *units);
+
+/**
+ * Attempts to solve a puzzle using the bitboard solver.
+ *
+ * Before every branching decision naked and hidden singles are placed. The solver branches on a cell with the
+ * fewest candidates.
+ *
+ * @param solver the initialized solver to solve with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_bitboard_solve_digits(
+        smalldoku_bitboard_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * The amount of 64 bit words needed for a set containing one bit per cell.
+ */
+#define SMALLDOKU_CELL_SET_WORDS ((SMALLDOKU_CELL_COUNT + 63) / 64)
+
+/**
+ * Compact representation of a game, about 120 bytes instead of the 3 bytes per cell of a grid.
+ *
+ * The current value of every cell is kept in a single digit array, so it can be passed directly to the digit based
+ * solver and generator functions. Whether a cell is part of the puzzle or has been filled by the user is kept in
+ * bit sets with the bit (n % 64) of word (n / 64) representing the cell with the row major index n.
+ */
+struct smalldoku_board {
+    /**
+     * The current values of all cells in row major order, 0 for empty cells.
+     */
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The cells which are part of the puzzle.
+     */
+    smalldoku_uint64_t given[SMALLDOKU_CELL_SET_WORDS];
+
+    /**
+     * The cells which have been filled by the user.
+     */
+    smalldoku_uint64_t user[SMALLDOKU_CELL_SET_WORDS];
+};
+
+typedef struct smalldoku_board smalldoku_board_t;
+
+/**
+ * Checks whether a cell is contained in a cell set.
+ *
+ * @param set the set to check
+ * @param cell_index the index of the cell in row major order
+ * @return 1 if the cell is contained, 0 otherwise
+ */
+static inline int smalldoku_cell_set_has(const smalldoku_uint64_t *set, smalldoku_cell_index_t cell_index) {
+    return (set[cell_index / 64] >> (cell_index % 64)) & 1;
+}
+
+/**
+ * Empties all cells of a board.
+ *
+ * @param board the board to clear
+ */
+void smalldoku_board_clear(smalldoku_board_t *board);
+
+/**
+ * Makes a cell part of the puzzle.
+ *
+ * @param board the board to modify
+ * @param cell_index the index of the cell in row major order
+ * @param number the number of the cell, or 0 to remove the cell from the puzzle
+ */
+void smalldoku_board_set_given(smalldoku_board_t *board, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number);
+
+/**
+ * Fills a cell which is not part of the puzzle on behalf of the user.
+ *
+ * @param board the board to modify
+ * @param cell_index the index of the cell in row major order
+ * @param number the number the user entered, or 0 to empty the cell
+ */
+void smalldoku_board_set_user(smalldoku_board_t *board, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number);
+
+/**
+ * Converts a grid into a board.
+ *
+ * @param board the board to write to
+ * @param grid the grid to convert
+ */
+void smalldoku_board_from_grid(smalldoku_board_t *board, SMALLDOKU_GRID(grid));
+
+/**
+ * Converts a board into a grid.
+ *
+ * @param board the board to convert
+ * @param solution the SMALLDOKU_CELL_COUNT values of the solution in row major order, used as the value of the cells
+ *                 which are not part of the puzzle, or NULL to set their value to 0
+ * @param grid the grid to write to
+ */
+void smalldoku_board_to_grid(const smalldoku_board_t *board, const smalldoku_uint8_t *solution, SMALLDOKU_GRID(grid));
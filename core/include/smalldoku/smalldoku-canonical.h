@@ -0,0 +1,51 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * Reduces a puzzle and its solution to the canonical representative of all equivalent puzzles.
+ *
+ * Two puzzles are equivalent if one can be turned into the other by relabeling the numbers, transposing, swapping
+ * bands, swapping rows within a band, swapping stacks and swapping columns within a stack. All equivalent puzzles
+ * have the same canonical form, so comparing canonical forms (or their hashes) finds duplicates.
+ *
+ * The canonical solution is the lexicographically smallest row major solution reachable by the transformations,
+ * which always starts with the row 1 to SMALLDOKU_GRID_WIDTH. If several transformations reach it, the one giving the
+ * smallest puzzle is picked. The column orders are searched depth first stack by stack, abandoning a branch as soon as
+ * the second row can only compare larger than the best solution found so far, and the rows are chosen greedily below
+ * the first one.
+ *
+ * @param puzzle the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param solution the SMALLDOKU_CELL_COUNT values of the unique solution of the puzzle in row major order
+ * @param canonical_puzzle buffer of SMALLDOKU_CELL_COUNT values to write the canonical puzzle to, may alias puzzle
+ * @param canonical_solution buffer of SMALLDOKU_CELL_COUNT values to write the canonical solution to, may alias
+ *                           solution, or NULL to not write it
+ * @return the hash of the canonical puzzle, see smalldoku_hash_digits
+ */
+smalldoku_uint64_t smalldoku_canonicalize_digits(
+        const smalldoku_uint8_t *puzzle,
+        const smalldoku_uint8_t *solution,
+        smalldoku_uint8_t *canonical_puzzle,
+        smalldoku_uint8_t *canonical_solution
+);
+
+/**
+ * Transforms a grid into its canonical form, see smalldoku_canonicalize_digits.
+ *
+ * The generated cells make up the puzzle and the values of all cells the solution. Values the user put into the grid
+ * are cleared.
+ *
+ * @param grid the grid to canonicalize, the values of all cells must form the solution of the generated cells
+ * @return the hash of the canonical puzzle, see smalldoku_hash_digits
+ */
+smalldoku_uint64_t smalldoku_canonicalize_grid(SMALLDOKU_GRID(grid));
+
+/**
+ * Hashes raw cell values.
+ *
+ * The hash only depends on the values, so it is stable across runs and machines and can be stored in puzzle banks.
+ *
+ * @param digits the SMALLDOKU_CELL_COUNT values to hash in row major order
+ * @return the 64 bit FNV-1a hash of the values
+ */
+smalldoku_uint64_t smalldoku_hash_digits(const smalldoku_uint8_t *digits);
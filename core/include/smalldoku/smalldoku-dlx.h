@@ -0,0 +1,124 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * The maximum amount of constraints of the exact cover matrix: every cell has to be filled and every unit has to
+ * contain every number exactly once.
+ */
+#define SMALLDOKU_DLX_COLUMN_COUNT (SMALLDOKU_CELL_COUNT + SMALLDOKU_MAX_UNITS * SMALLDOKU_GRID_WIDTH)
+
+/**
+ * The amount of possible placements of the exact cover matrix, one per cell and number.
+ */
+#define SMALLDOKU_DLX_ROW_COUNT (SMALLDOKU_CELL_COUNT * SMALLDOKU_GRID_WIDTH)
+
+/**
+ * The maximum amount of nodes in the matrix: the root, one header per column and per row one node for the cell plus
+ * one per unit of the cell.
+ */
+#define SMALLDOKU_DLX_NODE_COUNT \
+    (1 + SMALLDOKU_DLX_COLUMN_COUNT + (1 + SMALLDOKU_MAX_CELL_UNITS) * SMALLDOKU_DLX_ROW_COUNT)
+
+/**
+ * The index of a node in the matrix, 16 bits are enough for all grids up to 16x16.
+ */
+#if SMALLDOKU_DLX_NODE_COUNT <= 0xFFFF
+typedef smalldoku_uint16_t smalldoku_dlx_node_t;
+#else
+typedef smalldoku_uint32_t smalldoku_dlx_node_t;
+#endif
+
+/**
+ * Dancing links representation of the exact cover matrix of a grid.
+ *
+ * All nodes live in fixed size arrays sized for the variant with the most units, so the solver never allocates. The
+ * structure is large (about 55KiB with 9x9 grids, about 300KiB with 16x16 grids), so it should not be put on small
+ * stacks.
+ */
+struct smalldoku_dlx {
+    /**
+     * The units of the grid.
+     */
+    const smalldoku_units_t *units;
+
+    /**
+     * The amount of constraints of the matrix.
+     */
+    smalldoku_uint16_t column_count;
+
+    /**
+     * The distance between the first nodes of two consecutive rows, rows of cells with fewer units leave the nodes
+     * at their end unused.
+     */
+    smalldoku_uint16_t row_stride;
+
+    /**
+     * The node to the left of each node in its row.
+     */
+    smalldoku_dlx_node_t left[SMALLDOKU_DLX_NODE_COUNT];
+
+    /**
+     * The node to the right of each node in its row.
+     */
+    smalldoku_dlx_node_t right[SMALLDOKU_DLX_NODE_COUNT];
+
+    /**
+     * The node above each node in its column.
+     */
+    smalldoku_dlx_node_t up[SMALLDOKU_DLX_NODE_COUNT];
+
+    /**
+     * The node below each node in its column.
+     */
+    smalldoku_dlx_node_t down[SMALLDOKU_DLX_NODE_COUNT];
+
+    /**
+     * The column header of each node, column headers point to themselves.
+     */
+    smalldoku_dlx_node_t column[SMALLDOKU_DLX_NODE_COUNT];
+
+    /**
+     * The amount of rows still linked into each column, indexed by the column header node.
+     */
+    smalldoku_uint16_t size[1 + SMALLDOKU_DLX_COLUMN_COUNT];
+
+    /**
+     * The rows selected so far, given numbers first followed by the choices of the search.
+     */
+    smalldoku_dlx_node_t selected[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The values of the cells of the partial solution in row major order.
+     */
+    smalldoku_uint8_t cells[SMALLDOKU_CELL_COUNT];
+};
+
+typedef struct smalldoku_dlx smalldoku_dlx_t;
+
+/**
+ * Builds the exact cover matrix.
+ *
+ * This only needs to be done once, every solve leaves the matrix in its initial state.
+ *
+ * @param dlx the instance to initialize
+ * @param units the units of the grid to solve
+ */
+void smalldoku_dlx_init(smalldoku_dlx_t *dlx, const smalldoku_units_t *units);
+
+/**
+ * Attempts to solve a puzzle using Algorithm X on the dancing links matrix.
+ *
+ * The search always branches on the constraint with the fewest remaining possibilities.
+ *
+ * @param dlx the initialized instance to solve with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_dlx_solve_digits(
+        smalldoku_dlx_t *dlx,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+);
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-grader.h"
+#include "smalldoku/smalldoku-solver.h"
+
+/**
+ * Controls how far the generator digs and how much work it may spend.
+ */
+struct smalldoku_dig_options {
+    /**
+     * The amount of numbers to stop digging at, or 0 to dig until the puzzle is minimal.
+     */
+    smalldoku_cell_index_t target_clues;
+
+    /**
+     * The number of search nodes all uniqueness checks together may visit, or 0 for no limit.
+     */
+    smalldoku_uint64_t node_budget;
+
+    /**
+     * Flag polled before every search node, digging stops as soon as it is non-zero, or NULL.
+     */
+    const volatile int *cancel;
+
+    /**
+     * Statistics to add the work of all uniqueness checks to, or NULL.
+     */
+    smalldoku_stats_t *stats;
+
+    /**
+     * Pointer to write the number of search nodes used by all uniqueness checks to, or NULL.
+     */
+    smalldoku_uint64_t *node_count;
+
+    /**
+     * Pointer to write SMALLDOKU_SOLVE_COMPLETE to if digging finished, or the reason it stopped early, or NULL.
+     */
+    smalldoku_solve_status_t *status;
+
+    /**
+     * The hardest technique the puzzle may need, or SMALLDOKU_TECHNIQUE_NONE to only keep the solution unique.
+     *
+     * If set, a number is only erased if smalldoku_grade_digits still solves the puzzle without harder techniques.
+     * That already proves the solution unique, so no solver is run at all. Every pass of the grader over the units
+     * counts as SMALLDOKU_GRID_WIDTH search nodes against the node budget instead, see smalldoku_grade_t::passes.
+     */
+    smalldoku_technique_t max_technique;
+};
+
+typedef struct smalldoku_dig_options smalldoku_dig_options_t;
+
+/**
+ * Digs a puzzle out of a filled puzzle by erasing numbers (setting them to 0) while the solution stays unique.
+ *
+ * Every cell is visited exactly once in a random order. Erasing numbers only ever adds solutions, so a number which
+ * can't be erased when its cell is visited can't be erased later either: once all cells have been visited the
+ * puzzle is minimal. A number can be erased if no other number fits into its cell, which is checked by solving the
+ * puzzle with each other candidate of the cell put in as a given and stopping at the first solution. This performs at
+ * most SMALLDOKU_CELL_COUNT * (SMALLDOKU_GRID_WIDTH - 1) solves, all using the same solver.
+ *
+ * If the node budget runs out or digging is cancelled, the number being checked is kept and digging stops. The
+ * puzzle still has a unique solution, it just has more numbers than requested.
+ *
+ * @param solver the initialized solver to check the uniqueness with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, must have a unique solution
+ * @param rng the random number generator to use
+ * @param options the options controlling the dig
+ * @return the amount of numbers left in the puzzle
+ */
+smalldoku_cell_index_t smalldoku_dig_digits(
+        smalldoku_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+);
+
+/**
+ * Digs a puzzle out of a grid by marking generated cells as user cells, see smalldoku_dig_digits.
+ *
+ * Only generated cells are part of the puzzle, user cells are treated as empty.
+ *
+ * @param solver the initialized solver to check the uniqueness with
+ * @param grid the grid to dig, the generated cells must have a unique solution
+ * @param rng the random number generator to use
+ * @param options the options controlling the dig, the target applies to the generated cells
+ * @return the amount of generated cells left in the grid
+ */
+smalldoku_cell_index_t smalldoku_dig_grid(
+        smalldoku_solver_t *solver,
+        SMALLDOKU_GRID(grid),
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+);
+
+/**
+ * Fills a random solution to dig a puzzle out of, the first phase of smalldoku_generator_step.
+ *
+ * The classic grid is filled by smalldoku_transform_fill_digits without any search. Transformations of the base grids
+ * don't preserve the extra units of variants, so their solutions are searched by smalldoku_fill_digits instead.
+ *
+ * @param units the units of the variant to fill the solution for, or NULL for the classic grid
+ * @param solution buffer of SMALLDOKU_CELL_COUNT values to write the solution to in row major order
+ * @param rng the random number generator to use
+ * @return 1 if the solution has been filled, 0 if the variant doesn't admit any solution
+ */
+int smalldoku_generator_fill_digits(
+        const smalldoku_units_t *units,
+        smalldoku_uint8_t *solution,
+        smalldoku_rng_t *rng
+);
+
+/**
+ * Generates the random order smalldoku_dig_digits visits the cells in.
+ *
+ * @param order the array of SMALLDOKU_CELL_COUNT cell indices to write the order to
+ * @param rng the random number generator to use, advanced exactly like by smalldoku_dig_digits
+ */
+void smalldoku_dig_order(smalldoku_cell_index_t *order, smalldoku_rng_t *rng);
+
+/**
+ * Checks whether the number of a cell can be erased without the puzzle getting a second solution, the check
+ * smalldoku_dig_digits performs for every cell it visits.
+ *
+ * Erasing numbers only ever adds solutions, so a number which can be erased from a puzzle can also be erased from
+ * every puzzle containing it and more numbers of the same solution, while a number which can't be erased can't be
+ * erased from any puzzle with fewer numbers either. This allows checking cells ahead of the dig, see the parallel
+ * dig of the linux frontend. The outcome of a grader check (max_technique set) is not guaranteed to be monotonic like
+ * this.
+ *
+ * @param solver the initialized solver to check with
+ * @param digits the values of the puzzle, the cell is modified during the check but restored afterwards
+ * @param cell_index the index of the cell to check, must not be empty
+ * @param options the options of the dig, the target, node count and status members are not used
+ * @param node_count the number of search nodes used by the dig so far, increased by the nodes of the check and
+ *                   compared against the node budget of the options
+ * @param status pointer to write SMALLDOKU_SOLVE_BUDGET_EXHAUSTED or SMALLDOKU_SOLVE_CANCELLED to if the check could
+ *               not be finished, left untouched otherwise
+ * @return 1 if the number can be erased, 0 otherwise or if the check could not be finished
+ */
+int smalldoku_dig_is_removable(
+        smalldoku_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t cell_index,
+        const smalldoku_dig_options_t *options,
+        smalldoku_uint64_t *node_count,
+        smalldoku_solve_status_t *status
+);
+
+/**
+ * The phases of a time sliced generator.
+ */
+enum smalldoku_generator_phase {
+    /**
+     * The solution grid still needs to be generated.
+     */
+    SMALLDOKU_GENERATOR_FILL,
+
+    /**
+     * Numbers are being erased from the solution.
+     */
+    SMALLDOKU_GENERATOR_DIG,
+
+    /**
+     * The puzzle is finished.
+     */
+    SMALLDOKU_GENERATOR_DONE
+};
+
+typedef enum smalldoku_generator_phase smalldoku_generator_phase_t;
+
+/**
+ * Generator producing a puzzle in many small steps, for event loops which can't block for a whole generation.
+ *
+ * The generator fills a solution using smalldoku_transform_fill_digits (smalldoku_fill_digits for variants, whose
+ * units the transformations don't preserve) and then digs it like smalldoku_dig_digits, remembering how far it got
+ * between steps. The puzzle only becomes visible through smalldoku_generator_get_grid once it is finished, so a half
+ * dug puzzle never shows up in the UI.
+ */
+struct smalldoku_generator {
+    /**
+     * The solver used for the uniqueness checks, owned by the caller.
+     */
+    smalldoku_solver_t *solver;
+
+    /**
+     * The random number generator to use, owned by the caller.
+     */
+    smalldoku_rng_t *rng;
+
+    /**
+     * The amount of numbers to stop digging at, or 0 to dig until the puzzle is minimal.
+     */
+    smalldoku_cell_index_t target_clues;
+
+    /**
+     * The hardest technique the puzzle may need, or SMALLDOKU_TECHNIQUE_NONE to only keep the solution unique.
+     */
+    smalldoku_technique_t max_technique;
+
+    /**
+     * The current phase, one of smalldoku_generator_phase_t.
+     */
+    smalldoku_uint8_t phase;
+
+    /**
+     * The amount of cells of the visiting order which have been visited.
+     */
+    smalldoku_cell_index_t visited;
+
+    /**
+     * The amount of numbers left in the puzzle.
+     */
+    smalldoku_cell_index_t clues;
+
+    /**
+     * The order to visit the cells in.
+     */
+    smalldoku_cell_index_t order[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The solution in row major order.
+     */
+    smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The puzzle in row major order, 0 for erased cells.
+     */
+    smalldoku_uint8_t puzzle[SMALLDOKU_CELL_COUNT];
+};
+
+typedef struct smalldoku_generator smalldoku_generator_t;
+
+/**
+ * Starts generating a new puzzle, discarding any generation in progress.
+ *
+ * This does no work by itself, all work is done by smalldoku_generator_step.
+ *
+ * @param generator the generator to start
+ * @param solver the initialized solver to check the uniqueness with, must outlive the generation
+ * @param target_clues the amount of numbers to stop digging at, or 0 to dig until the puzzle is minimal
+ * @param max_technique the hardest technique the puzzle may need, see smalldoku_dig_options_t::max_technique
+ * @param rng the random number generator to use
+ */
+void smalldoku_generator_start(
+        smalldoku_generator_t *generator,
+        smalldoku_solver_t *solver,
+        smalldoku_cell_index_t target_clues,
+        smalldoku_technique_t max_technique,
+        smalldoku_rng_t *rng
+);
+
+/**
+ * Continues generating the puzzle.
+ *
+ * Work is measured in search nodes of the uniqueness checks (or grader passes, see smalldoku_dig_options_t) plus one
+ * per visited cell. A started check is always finished, so a step may exceed max_work by the work of a single check.
+ *
+ * @param generator the generator to continue
+ * @param max_work the amount of work after which the step returns
+ * @return 1 if the puzzle is finished, 0 if more steps are needed
+ */
+int smalldoku_generator_step(smalldoku_generator_t *generator, smalldoku_uint64_t max_work);
+
+/**
+ * Retrieves how far the generation has progressed.
+ *
+ * @param generator the generator to query
+ * @return the progress in percent
+ */
+smalldoku_uint8_t smalldoku_generator_progress(const smalldoku_generator_t *generator);
+
+/**
+ * Writes the finished puzzle into a grid, erased cells become user cells.
+ *
+ * @param generator the generator whose puzzle is finished
+ * @param grid the grid to write the puzzle to
+ */
+void smalldoku_generator_get_grid(const smalldoku_generator_t *generator, SMALLDOKU_GRID(grid));
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * The deductions of the logical grader, ordered from the easiest to the hardest.
+ *
+ * The values are stable and may be stored, for example as the difficulty of bank entries.
+ */
+enum smalldoku_technique {
+    /**
+     * No deduction was needed, the puzzle was already filled.
+     */
+    SMALLDOKU_TECHNIQUE_NONE = 0,
+
+    /**
+     * A number fits into only one cell of a unit.
+     */
+    SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE,
+
+    /**
+     * A cell can only take a single number.
+     */
+    SMALLDOKU_TECHNIQUE_NAKED_SINGLE,
+
+    /**
+     * All cells of a unit which can take a number also share another unit, so no other cell of that unit can take
+     * it (pointing and claiming).
+     */
+    SMALLDOKU_TECHNIQUE_LOCKED_CANDIDATES,
+
+    /**
+     * Two cells of a unit can only take the same two numbers.
+     */
+    SMALLDOKU_TECHNIQUE_NAKED_PAIR,
+
+    /**
+     * A number fits into the same two cells in two rows (or columns), so no other cell of those columns (or rows)
+     * can take it.
+     */
+    SMALLDOKU_TECHNIQUE_X_WING,
+
+    /**
+     * Two numbers of a unit only fit into the same two cells.
+     */
+    SMALLDOKU_TECHNIQUE_HIDDEN_PAIR,
+
+    /**
+     * Three cells of a unit can only take the same three numbers.
+     */
+    SMALLDOKU_TECHNIQUE_NAKED_TRIPLE,
+
+    /**
+     * The X-Wing with three rows and columns.
+     */
+    SMALLDOKU_TECHNIQUE_SWORDFISH,
+
+    /**
+     * Three numbers of a unit only fit into the same three cells.
+     */
+    SMALLDOKU_TECHNIQUE_HIDDEN_TRIPLE,
+
+    /**
+     * Four cells of a unit can only take the same four numbers.
+     */
+    SMALLDOKU_TECHNIQUE_NAKED_QUAD,
+
+    /**
+     * The X-Wing with four rows and columns.
+     */
+    SMALLDOKU_TECHNIQUE_JELLYFISH,
+
+    /**
+     * Four numbers of a unit only fit into the same four cells.
+     */
+    SMALLDOKU_TECHNIQUE_HIDDEN_QUAD,
+
+    /**
+     * The techniques above got stuck, the puzzle needs guessing or has no solution at all.
+     */
+    SMALLDOKU_TECHNIQUE_GUESSING,
+
+    /**
+     * The amount of values of this enum.
+     */
+    SMALLDOKU_TECHNIQUE_COUNT
+};
+
+typedef enum smalldoku_technique smalldoku_technique_t;
+
+/**
+ * The result of grading a puzzle.
+ */
+struct smalldoku_grade {
+    /**
+     * The hardest technique which was needed, SMALLDOKU_TECHNIQUE_GUESSING if the puzzle could not be solved.
+     */
+    smalldoku_technique_t hardest;
+
+    /**
+     * The sum of the costs of all deductions made, every placed number and every successful elimination costs more
+     * the harder its technique is. Every cell left empty when the grader got stuck adds the cost of a guess.
+     */
+    smalldoku_uint32_t rating;
+
+    /**
+     * How often every technique has been applied.
+     */
+    smalldoku_uint16_t counts[SMALLDOKU_TECHNIQUE_COUNT];
+
+    /**
+     * The amount of times a technique has been tried, successful or not. Every try scans all units (or rows and
+     * columns) once, which makes this a measure of the work the grader did.
+     */
+    smalldoku_uint32_t passes;
+};
+
+typedef struct smalldoku_grade smalldoku_grade_t;
+
+/**
+ * Solves a puzzle the way a human would, applying the easiest technique which makes progress until the puzzle is
+ * solved or no technique applies anymore.
+ *
+ * All techniques only ever remove candidates which can't be part of any solution, so a puzzle solved by the grader
+ * has a unique solution and no search is needed to prove it. The grader works on candidate masks and the unit
+ * tables only, its whole state lives on the stack (a few hundred bytes with 9x9 grids).
+ *
+ * X-Wing, Swordfish and Jellyfish only consider rows and columns, all other techniques apply to every unit of the
+ * variant.
+ *
+ * @param units the units of the variant to grade the puzzle for, or NULL for the classic grid
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param max_technique the hardest technique to apply, harder puzzles are reported as needing guesses
+ * @param grade the grade to write the result to
+ * @return 1 if the puzzle has been solved, 0 if it needs harder techniques or has no solution
+ */
+int smalldoku_grade_digits(
+        const smalldoku_units_t *units,
+        const smalldoku_uint8_t *digits,
+        smalldoku_technique_t max_technique,
+        smalldoku_grade_t *grade
+);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * The instruction set extensions the memory primitives can be implemented with.
+ */
+enum smalldoku_memory_isa {
+    /**
+     * 16 byte vectors, available on every x86-64 processor.
+     */
+    SMALLDOKU_MEMORY_SSE2,
+
+    /**
+     * 32 byte vectors, available if both the processor and the system (which has to save the upper halves of the
+     * vector registers) support them.
+     */
+    SMALLDOKU_MEMORY_AVX2
+};
+
+typedef enum smalldoku_memory_isa smalldoku_memory_isa_t;
+
+/**
+ * Selects the fastest implementation of the memory primitives the processor supports, using CPUID.
+ *
+ * Should be called once at startup, before any other thread uses the primitives. Until then the SSE2 implementations
+ * are used, so calling the primitives before is safe, just slower. Firmware commonly does not enable the AVX state, in
+ * which case the SSE2 implementations stay selected.
+ *
+ * @return the instruction set extension selected
+ */
+smalldoku_memory_isa_t smalldoku_memory_init(void);
+
+/**
+ * Copies bytes between non overlapping buffers.
+ *
+ * @param destination the buffer to copy to
+ * @param source the buffer to copy from
+ * @param size the amount of bytes to copy
+ * @return the destination
+ */
+void *smalldoku_memcpy(void *destination, const void *source, smalldoku_size_t size);
+
+/**
+ * Sets all bytes of a buffer to the same value.
+ *
+ * @param destination the buffer to set
+ * @param value the value to set every byte to
+ * @param size the amount of bytes to set
+ * @return the destination
+ */
+void *smalldoku_memset(void *destination, smalldoku_uint8_t value, smalldoku_size_t size);
+
+/**
+ * Sets all 32 bit values of a buffer to the same value, for example pixels to a color.
+ *
+ * @param destination the buffer to set, must be aligned to 4 bytes
+ * @param value the value to set every element to
+ * @param count the amount of 32 bit values to set
+ */
+void smalldoku_memset32(smalldoku_uint32_t *destination, smalldoku_uint32_t value, smalldoku_size_t count);
+
+/**
+ * Fills a rectangle of an image with 32 bit pixels with the same value.
+ *
+ * @param destination the first pixel of the rectangle, must be aligned to 4 bytes
+ * @param pitch the distance between the rows of the image in pixels
+ * @param width the width of the rectangle in pixels
+ * @param height the height of the rectangle in pixels
+ * @param value the value to set every pixel to
+ */
+void smalldoku_fill_rect32(
+        smalldoku_uint32_t *destination,
+        smalldoku_size_t pitch,
+        smalldoku_uint32_t width,
+        smalldoku_uint32_t height,
+        smalldoku_uint32_t value
+);
+
+/**
+ * Copies a rectangle of 32 bit pixels between non overlapping images.
+ *
+ * @param destination the first pixel of the rectangle to copy to, must be aligned to 4 bytes
+ * @param destination_pitch the distance between the rows of the destination image in pixels
+ * @param source the first pixel of the rectangle to copy, must be aligned to 4 bytes
+ * @param source_pitch the distance between the rows of the source image in pixels
+ * @param width the width of the rectangle in pixels
+ * @param height the height of the rectangle in pixels
+ */
+void smalldoku_copy_rect32(
+        smalldoku_uint32_t *destination,
+        smalldoku_size_t destination_pitch,
+        const smalldoku_uint32_t *source,
+        smalldoku_size_t source_pitch,
+        smalldoku_uint32_t width,
+        smalldoku_uint32_t height
+);
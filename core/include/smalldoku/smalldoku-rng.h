@@ -0,0 +1,53 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * State of a xoshiro256** pseudo random number generator.
+ *
+ * Given the same seed the generator always produces the same numbers, so everything generated from it can be
+ * reproduced from the seed alone. The state must not be all zero, which smalldoku_rng_seed guarantees.
+ */
+struct smalldoku_rng {
+    /**
+     * The 256 bits of state.
+     */
+    smalldoku_uint64_t state[4];
+};
+
+/**
+ * Seeds a generator, expanding the seed into the full state using splitmix64.
+ *
+ * @param rng the generator to seed
+ * @param seed the seed to start from, any value is fine
+ */
+void smalldoku_rng_seed(smalldoku_rng_t *rng, smalldoku_uint64_t seed);
+
+/**
+ * Generates the next 64 random bits.
+ *
+ * @param rng the generator to advance
+ * @return the generated bits
+ */
+smalldoku_uint64_t smalldoku_rng_next(smalldoku_rng_t *rng);
+
+/**
+ * Generates a random number in a range without modulo bias.
+ *
+ * @param rng the generator to advance
+ * @param min the smallest number to generate
+ * @param max the largest number to generate, must not be smaller than min
+ * @return the generated number
+ */
+smalldoku_uint16_t smalldoku_rng_range(smalldoku_rng_t *rng, smalldoku_uint16_t min, smalldoku_uint16_t max);
+
+/**
+ * Splits off an independent stream, for example to give every thread its own generator.
+ *
+ * The split off generator continues where rng currently is, while rng jumps 2^128 numbers ahead. Streams split off
+ * one after another therefore never overlap in practice, and splitting is as reproducible as generating.
+ *
+ * @param rng the generator to split, is advanced past the split off stream
+ * @param out the generator to write the split off stream to
+ */
+void smalldoku_rng_split(smalldoku_rng_t *rng, smalldoku_rng_t *out);
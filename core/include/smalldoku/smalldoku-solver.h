@@ -0,0 +1,124 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-backtrack.h"
+#include "smalldoku/smalldoku-dlx.h"
+#include "smalldoku/smalldoku-bitboard.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * The algorithm a solver uses to search for solutions.
+ */
+enum smalldoku_solver_backend {
+    /**
+     * Backtracking on occupancy masks, honors the branching and propagation settings.
+     */
+    SMALLDOKU_SOLVER_BACKTRACK,
+
+    /**
+     * Algorithm X on a dancing links exact cover matrix.
+     */
+    SMALLDOKU_SOLVER_DLX,
+
+    /**
+     * Candidate bitboards updated with vector operations.
+     */
+    SMALLDOKU_SOLVER_BITBOARD
+};
+
+typedef enum smalldoku_solver_backend smalldoku_solver_backend_t;
+
+/**
+ * Configuration of a solver, fixed at initialization.
+ */
+struct smalldoku_solver_config {
+    /**
+     * The algorithm to use.
+     */
+    smalldoku_solver_backend_t backend;
+
+    /**
+     * The strategy to use for selecting the cell to branch on, only used by the backtracking backend.
+     */
+    smalldoku_branching_t branching;
+
+    /**
+     * The deductions to apply before every branching decision, only used by the backtracking backend.
+     */
+    smalldoku_propagation_t propagation;
+
+    /**
+     * The units of the variant to solve, or NULL for the classic grid. The units must outlive the solver.
+     */
+    const smalldoku_units_t *units;
+};
+
+typedef struct smalldoku_solver_config smalldoku_solver_config_t;
+
+/**
+ * Solver context owning all scratch memory of its backend.
+ *
+ * The input grid is only ever read, so any number of solvers can work on the same grid concurrently. A single
+ * solver must not be used by multiple threads at the same time. Depending on the backend the context holds large
+ * tables (about 55KiB for DLX with 9x9 grids), so it should not be put on small stacks.
+ */
+struct smalldoku_solver {
+    /**
+     * The algorithm the solver has been initialized with.
+     */
+    smalldoku_solver_backend_t backend;
+
+    /**
+     * The units of the grid the solver has been initialized for.
+     */
+    const smalldoku_units_t *units;
+
+    /**
+     * The state of the selected backend.
+     */
+    union {
+        smalldoku_backtrack_t backtrack;
+        smalldoku_dlx_t dlx;
+        smalldoku_bitboard_solver_t bitboard;
+    } engine;
+};
+
+typedef struct smalldoku_solver smalldoku_solver_t;
+
+/**
+ * Initializes a solver, building all lookup tables the backend needs.
+ *
+ * This only needs to be done once, the solver can be reused for any number of solves without further setup.
+ *
+ * @param solver the solver to initialize
+ * @param config the configuration to use
+ */
+void smalldoku_solver_init(smalldoku_solver_t *solver, const smalldoku_solver_config_t *config);
+
+/**
+ * Attempts to solve a puzzle given as raw cell values.
+ *
+ * @param solver the initialized solver to solve with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_solver_solve_digits(
+        smalldoku_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+);
+
+/**
+ * Attempts to solve a grid without modifying it.
+ *
+ * @param solver the initialized solver to solve with
+ * @param grid the grid to solve
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_solver_solve_grid(
+        smalldoku_solver_t *solver,
+        SMALLDOKU_GRID(grid),
+        const smalldoku_solve_options_t *options
+);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * The outcome of splitting a puzzle.
+ */
+enum smalldoku_split_result {
+    /**
+     * The puzzle has to be branched on, see smalldoku_split_t.
+     */
+    SMALLDOKU_SPLIT_BRANCH,
+
+    /**
+     * All cells have been filled without branching, the puzzle now holds its only solution.
+     */
+    SMALLDOKU_SPLIT_SOLVED,
+
+    /**
+     * The puzzle has no solution.
+     */
+    SMALLDOKU_SPLIT_CONTRADICTION
+};
+
+typedef enum smalldoku_split_result smalldoku_split_result_t;
+
+/**
+ * Describes the branching decision at the top of the search tree of a puzzle.
+ *
+ * Every candidate of the cell yields one subproblem: the puzzle with the number put into the cell. The solutions of
+ * the subproblems are disjoint and together exactly the solutions of the puzzle, so they can be solved (or split
+ * again) independently of each other, for example by different threads, and their solution counts added up.
+ */
+struct smalldoku_split {
+    /**
+     * The index of the cell to branch on in row major order.
+     */
+    smalldoku_cell_index_t cell;
+
+    /**
+     * The numbers which can be put into the cell, at least two.
+     */
+    smalldoku_number_mask_t candidates;
+
+    /**
+     * The amount of empty cells left in the puzzle, a rough measure of the size of the subproblems.
+     */
+    smalldoku_cell_index_t empty;
+};
+
+typedef struct smalldoku_split smalldoku_split_t;
+
+/**
+ * Splits a puzzle into the subproblems of its top branching decision.
+ *
+ * All numbers forced by naked and hidden singles are put into the puzzle first, which never changes its solutions. The
+ * cell with the fewest candidates is then chosen to branch on, the same choice the solvers make. The function only
+ * reads the unit tables and keeps its state on the stack, so it can be called from any number of threads at the same
+ * time.
+ *
+ * @param units the units of the variant, or NULL for the classic grid
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells, forced numbers
+ *               are written back to it
+ * @param split the branching decision to write to, only valid if SMALLDOKU_SPLIT_BRANCH is returned
+ * @return whether the puzzle needs to be branched on, has been solved or has no solution
+ */
+smalldoku_split_result_t smalldoku_split_digits(
+        const smalldoku_units_t *units,
+        smalldoku_uint8_t *digits,
+        smalldoku_split_t *split
+);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * The length of a puzzle in the line format, one character per cell in row major order.
+ *
+ * Numbers up to 9 are written as their digit and larger ones as letters starting with 'A' for 10. Empty cells are
+ * written as '.', and read from either '.' or '0'. With 9x9 grids this is the common 81 character format.
+ */
+#define SMALLDOKU_TEXT_LENGTH SMALLDOKU_CELL_COUNT
+
+/**
+ * Reads a puzzle from the line format.
+ *
+ * Only the first SMALLDOKU_TEXT_LENGTH characters are read, whatever follows them (a line break, a rating or another
+ * comment) is ignored.
+ *
+ * @param text the characters to read
+ * @param length the amount of characters available
+ * @param digits buffer of SMALLDOKU_CELL_COUNT values to write the puzzle to in row major order, 0 for empty cells
+ * @return 1 if the text starts with a puzzle, 0 if it is too short or contains a character which is no cell
+ */
+int smalldoku_text_parse_digits(const char *text, smalldoku_size_t length, smalldoku_uint8_t *digits);
+
+/**
+ * Writes a puzzle or solution in the line format.
+ *
+ * @param digits the SMALLDOKU_CELL_COUNT values to write in row major order, 0 for empty cells
+ * @param text buffer of SMALLDOKU_TEXT_LENGTH characters to write to, no line break or terminator is written
+ */
+void smalldoku_text_format_digits(const smalldoku_uint8_t *digits, char *text);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * Fills a grid with a random solution by transforming a base grid.
+ *
+ * Unlike smalldoku_fill_grid this never searches: a base grid is picked from a small embedded catalog (or derived
+ * from a fixed pattern for grid sizes without a catalog) and shuffled using transformations which keep every grid
+ * valid: relabeling the numbers, transposing, swapping rows within a band, swapping bands, swapping columns within
+ * a stack and swapping stacks. The work is constant and given the same random numbers the result is the same.
+ *
+ * All cell values are overwritten, values already present in the grid are not taken into account.
+ *
+ * @param grid the grid to fill
+ * @param rng the random number generator to use
+ */
+void smalldoku_transform_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_t *rng);
+
+/**
+ * Fills a puzzle with a random solution by transforming a base grid, see smalldoku_transform_fill_grid.
+ *
+ * @param digits buffer of SMALLDOKU_CELL_COUNT values to write the solution to in row major order
+ * @param rng the random number generator to use
+ */
+void smalldoku_transform_fill_digits(smalldoku_uint8_t *digits, smalldoku_rng_t *rng);
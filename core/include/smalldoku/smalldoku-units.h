@@ -0,0 +1,118 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/**
+ * The amount of hyper squares (windoku windows) per row and column of squares: the windows sit between the regular
+ * squares, one cell in from the border and separated by one cell from each other.
+ */
+#define SMALLDOKU_HYPER_SQUARES_PER_ROW ((SMALLDOKU_GRID_WIDTH - 1) / (SMALLDOKU_SQUARE_WIDTH + 1))
+#define SMALLDOKU_HYPER_SQUARES_PER_COLUMN ((SMALLDOKU_GRID_HEIGHT - 1) / (SMALLDOKU_SQUARE_HEIGHT + 1))
+
+/**
+ * The amount of units a variant may add on top of the rows, columns and regions: two diagonals and the hyper squares.
+ */
+#define SMALLDOKU_MAX_EXTRA_UNITS (2 + SMALLDOKU_HYPER_SQUARES_PER_ROW * SMALLDOKU_HYPER_SQUARES_PER_COLUMN)
+
+/**
+ * The maximum amount of units of a grid.
+ */
+#define SMALLDOKU_MAX_UNITS (SMALLDOKU_GRID_HEIGHT + 2 * SMALLDOKU_GRID_WIDTH + SMALLDOKU_MAX_EXTRA_UNITS)
+
+/**
+ * The maximum amount of units a single cell belongs to: its row, column and region, both diagonals and one hyper
+ * square.
+ */
+#define SMALLDOKU_MAX_CELL_UNITS 6
+
+/**
+ * The maximum amount of peers of a single cell, that is other cells sharing at least one unit with it.
+ */
+#define SMALLDOKU_MAX_PEERS (SMALLDOKU_MAX_CELL_UNITS * (SMALLDOKU_GRID_WIDTH - 1))
+
+/**
+ * Additional rules on top of the classic rows, columns and squares, may be combined.
+ */
+enum smalldoku_variant {
+    /**
+     * The classic rules, every row, column and square contains every number once.
+     */
+    SMALLDOKU_VARIANT_CLASSIC = 0,
+
+    /**
+     * Both main diagonals contain every number once (Sudoku-X).
+     */
+    SMALLDOKU_VARIANT_DIAGONAL = 1 << 0,
+
+    /**
+     * The hyper squares between the regular squares contain every number once (windoku).
+     */
+    SMALLDOKU_VARIANT_HYPER = 1 << 1,
+
+    /**
+     * Irregularly shaped regions replace the squares (jigsaw).
+     */
+    SMALLDOKU_VARIANT_JIGSAW = 1 << 2
+};
+
+typedef enum smalldoku_variant smalldoku_variant_t;
+
+/**
+ * The units of a grid, groups of SMALLDOKU_GRID_WIDTH cells which must contain every number exactly once, together
+ * with the lookup tables derived from them.
+ *
+ * All geometry of the solvers and the generator goes through these tables, so supporting a variant only requires
+ * adding units. The tables of the classic grid are generated at build time, see smalldoku_classic_units. With 9x9
+ * grids the structure is about 5KiB large, with 16x16 grids about 50KiB.
+ */
+struct smalldoku_units {
+    /**
+     * The amount of units, the rows come first, followed by the columns, the regions and the extra units of the
+     * variant.
+     */
+    smalldoku_uint8_t unit_count;
+
+    /**
+     * The cells of every unit in row major order.
+     */
+    smalldoku_cell_index_t cells[SMALLDOKU_MAX_UNITS][SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * The amount of units every cell belongs to, at least 3.
+     */
+    smalldoku_uint8_t cell_unit_count[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The units every cell belongs to, its row, column and region always come first.
+     */
+    smalldoku_uint8_t cell_units[SMALLDOKU_CELL_COUNT][SMALLDOKU_MAX_CELL_UNITS];
+
+    /**
+     * The amount of peers of every cell.
+     */
+    smalldoku_uint8_t peer_count[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The other cells sharing at least one unit with every cell, in ascending order.
+     */
+    smalldoku_cell_index_t peers[SMALLDOKU_CELL_COUNT][SMALLDOKU_MAX_PEERS];
+};
+
+/**
+ * The units of the classic grid, generated at build time by tools/generate-units.c.
+ */
+extern const smalldoku_units_t smalldoku_classic_units;
+
+/**
+ * Builds the units of a variant.
+ *
+ * Whether the jigsaw regions admit any solution at all is not checked, generating puzzles for regions without a
+ * solution does not finish in reasonable time.
+ *
+ * @param units the units to build
+ * @param variants the combination of smalldoku_variant_t flags to build the units for
+ * @param regions the region index (0 to SMALLDOKU_GRID_WIDTH - 1) of every cell in row major order if
+ *                SMALLDOKU_VARIANT_JIGSAW is set, ignored (may be NULL) otherwise
+ * @return 1 if the units have been built, 0 if the regions don't all have SMALLDOKU_GRID_WIDTH cells
+ */
+int smalldoku_units_init(smalldoku_units_t *units, smalldoku_uint8_t variants, const smalldoku_uint8_t *regions);
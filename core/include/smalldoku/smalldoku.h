@@ -1,11 +1,26 @@
 #pragma once
 
-#define SMALLDOKU_GRID_WIDTH 9
-#define SMALLDOKU_GRID_HEIGHT 9
+/*
+ * The grid size is fixed at compile time by the size of the squares, which may be overridden by the build (see the
+ * SMALLDOKU_GRID_SIZE CMake option). Grids are square, every row, column and square holds one number per cell.
+ */
+#ifndef SMALLDOKU_SQUARE_WIDTH
 #define SMALLDOKU_SQUARE_WIDTH 3
+#endif
+
+#ifndef SMALLDOKU_SQUARE_HEIGHT
 #define SMALLDOKU_SQUARE_HEIGHT 3
+#endif
+
+#define SMALLDOKU_GRID_WIDTH (SMALLDOKU_SQUARE_WIDTH * SMALLDOKU_SQUARE_HEIGHT)
+#define SMALLDOKU_GRID_HEIGHT (SMALLDOKU_SQUARE_WIDTH * SMALLDOKU_SQUARE_HEIGHT)
+#define SMALLDOKU_CELL_COUNT (SMALLDOKU_GRID_WIDTH * SMALLDOKU_GRID_HEIGHT)
 #define SMALLDOKU_GRID(x) smalldoku_cell_t x[SMALLDOKU_GRID_WIDTH][SMALLDOKU_GRID_HEIGHT]
 
+#if SMALLDOKU_GRID_WIDTH > 32
+#error "Grids with more than 32 numbers are not supported"
+#endif
+
 typedef signed char smalldoku_int8_t;
 typedef signed short smalldoku_int16_t;
 typedef signed int smalldoku_int32_t;
@@ -17,8 +32,50 @@ typedef unsigned int smalldoku_uint32_t;
 typedef unsigned long smalldoku_uint64_t;
 
 typedef smalldoku_uint64_t smalldoku_ptrdiff_t;
+typedef smalldoku_uint64_t smalldoku_size_t;
+
+/**
+ * Bit mask containing one bit per number, the bit (n - 1) is set if the number n is contained.
+ *
+ * The narrowest type holding SMALLDOKU_GRID_WIDTH bits is used.
+ */
+#if SMALLDOKU_GRID_WIDTH <= 8
+typedef smalldoku_uint8_t smalldoku_number_mask_t;
+#elif SMALLDOKU_GRID_WIDTH <= 16
+typedef smalldoku_uint16_t smalldoku_number_mask_t;
+#else
+typedef smalldoku_uint32_t smalldoku_number_mask_t;
+#endif
 
-typedef smalldoku_uint8_t(*smalldoku_rng_fn)(smalldoku_uint8_t min, smalldoku_uint8_t max);
+/**
+ * Index of a cell in row major order, or an amount of cells.
+ *
+ * The narrowest type holding SMALLDOKU_CELL_COUNT is used.
+ */
+#if SMALLDOKU_CELL_COUNT <= 255
+typedef smalldoku_uint8_t smalldoku_cell_index_t;
+#else
+typedef smalldoku_uint16_t smalldoku_cell_index_t;
+#endif
+
+/**
+ * Pseudo random number generator state, see smalldoku-rng.h.
+ */
+typedef struct smalldoku_rng smalldoku_rng_t;
+
+/**
+ * The units of a grid and their lookup tables, see smalldoku-units.h.
+ */
+typedef struct smalldoku_units smalldoku_units_t;
+
+/**
+ * Function called by the solver for every solution found.
+ *
+ * @param solution the values of all cells of the solution in row major order
+ * @param user_data the user data passed to the solver
+ * @return 1 to continue the search, 0 to stop it
+ */
+typedef int(*smalldoku_solution_fn)(const smalldoku_uint8_t *solution, void *user_data);
 
 /**
  * Determines the type of a cell
@@ -42,9 +99,9 @@ typedef enum smalldoku_cell_type smalldoku_cell_type_t;
  */
 struct smalldoku_cell {
     /**
-     * The type of the cell
+     * The type of the cell, one of smalldoku_cell_type_t
      */
-    smalldoku_cell_type_t type;
+    smalldoku_uint8_t type;
 
     /**
      * The value of the cell - this always contains the value the cell is supposed to have for SMALLDOKU_USER_CELL
@@ -57,14 +114,131 @@ struct smalldoku_cell {
      * SMALLDOKU_GENERATED_CELL cells.
      */
     smalldoku_uint8_t user_value;
+};
+
+typedef struct smalldoku_cell smalldoku_cell_t;
+
+/**
+ * Describes why a search ended.
+ */
+enum smalldoku_solve_status {
+    /**
+     * The whole search space has been searched, the solution count is exact.
+     */
+    SMALLDOKU_SOLVE_COMPLETE,
+
+    /**
+     * The solution limit has been reached or the visitor requested to stop.
+     */
+    SMALLDOKU_SOLVE_STOPPED,
+
+    /**
+     * The node budget has been used up before the search could finish, the solution count is a lower bound.
+     */
+    SMALLDOKU_SOLVE_BUDGET_EXHAUSTED,
 
     /**
-     * User specific data, not used by the core library.
+     * The cancellation flag has been raised before the search could finish, the solution count is a lower bound.
      */
-    void *user_data;
+    SMALLDOKU_SOLVE_CANCELLED
 };
 
-typedef struct smalldoku_cell smalldoku_cell_t;
+typedef enum smalldoku_solve_status smalldoku_solve_status_t;
+
+/**
+ * Counters describing the work done by the solver and generator.
+ *
+ * The counters are only updated if the library has been built with SMALLDOKU_ENABLE_STATISTICS defined (the CMake
+ * option of the same name), otherwise they are left untouched. Counters are never reset by the library, so one
+ * instance can accumulate the work of many solves.
+ */
+struct smalldoku_stats {
+    /**
+     * The number of search nodes visited, that is numbers tentatively placed by branching.
+     */
+    smalldoku_uint64_t nodes;
+
+    /**
+     * The number of times the search had to return to an earlier decision, after a contradiction or a solution.
+     */
+    smalldoku_uint64_t backtracks;
+
+    /**
+     * The number of candidate computations, for a single cell or (for the bitboard solver) a whole board at once.
+     */
+    smalldoku_uint64_t candidate_checks;
+
+    /**
+     * The number of numbers placed by propagation instead of branching.
+     */
+    smalldoku_uint64_t propagations;
+
+    /**
+     * The deepest stack of branching decisions reached.
+     */
+    smalldoku_uint32_t max_depth;
+
+    /**
+     * The number of solves performed.
+     */
+    smalldoku_uint32_t solve_calls;
+};
+
+typedef struct smalldoku_stats smalldoku_stats_t;
+
+/**
+ * Controls how far the solver enumerates solutions and what it does with them.
+ */
+struct smalldoku_solve_options {
+    /**
+     * The number of solutions after which the search stops, or 0 to enumerate all solutions.
+     */
+    smalldoku_uint32_t solution_limit;
+
+    /**
+     * Buffer of SMALLDOKU_CELL_COUNT values to write the first solution found to in row major order, or NULL.
+     */
+    smalldoku_uint8_t *first_solution;
+
+    /**
+     * Function to call for every solution found, or NULL.
+     */
+    smalldoku_solution_fn visitor;
+
+    /**
+     * User data to pass to the visitor.
+     */
+    void *visitor_data;
+
+    /**
+     * Pointer to write the number of search nodes (numbers tentatively placed) to, or NULL.
+     */
+    smalldoku_uint64_t *node_count;
+
+    /**
+     * Statistics to add the work of the solve to, or NULL.
+     */
+    smalldoku_stats_t *stats;
+
+    /**
+     * The number of search nodes after which the search gives up, or 0 for no limit.
+     */
+    smalldoku_uint64_t node_budget;
+
+    /**
+     * Flag polled before every search node, the search gives up as soon as it is non-zero, or NULL.
+     *
+     * The flag may be raised from another thread or an interrupt handler.
+     */
+    const volatile int *cancel;
+
+    /**
+     * Pointer to write the reason the search ended to, or NULL.
+     */
+    smalldoku_solve_status_t *status;
+};
+
+typedef struct smalldoku_solve_options smalldoku_solve_options_t;
 
 /**
  * Initializes the sudoku grid
@@ -77,18 +251,51 @@ void smalldoku_init(SMALLDOKU_GRID(grid));
  * Fills the sudoku grid with random numbers
  *
  * @param grid the grid to fill
- * @param rng the function to use for generating random numbers
+ * @param rng the random number generator to use
  */
-void smalldoku_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_fn rng);
+void smalldoku_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_t *rng);
 
 /**
  * Erases a few numbers from the grid (by simply marking the cells as user cells).
  *
  * @param grid the grid to hammer
  * @param erase_count the number of cells to mark as user cells
- * @param rng the function to use for generating random numbers
+ * @param rng the random number generator to use
+ * @param stats statistics to add the work of all uniqueness checks to, or NULL
  */
-void smalldoku_hammer_grid(SMALLDOKU_GRID(grid), smalldoku_uint8_t erase_count, smalldoku_rng_fn rng);
+void smalldoku_hammer_grid(
+        SMALLDOKU_GRID(grid),
+        smalldoku_cell_index_t erase_count,
+        smalldoku_rng_t *rng,
+        smalldoku_stats_t *stats
+);
+
+/**
+ * Fills all empty cells of a puzzle with random numbers.
+ *
+ * @param units the units of the variant to fill the puzzle for, or NULL for the classic grid
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param rng the random number generator to use
+ * @return 1 if the puzzle could be filled, 0 if the given numbers can't be completed
+ */
+int smalldoku_fill_digits(const smalldoku_units_t *units, smalldoku_uint8_t *digits, smalldoku_rng_t *rng);
+
+/**
+ * Erases numbers from a filled puzzle (by setting them to 0) as long as the puzzle keeps a unique solution.
+ *
+ * Every cell is tried at most once, fewer numbers are erased if no more can be erased without losing uniqueness.
+ *
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param erase_count the number of cells to erase
+ * @param rng the random number generator to use
+ * @param stats statistics to add the work of all uniqueness checks to, or NULL
+ */
+void smalldoku_hammer_digits(
+        smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t erase_count,
+        smalldoku_rng_t *rng,
+        smalldoku_stats_t *stats
+);
 
 /**
  * Attempts to solve a grid.
@@ -98,6 +305,15 @@ void smalldoku_hammer_grid(SMALLDOKU_GRID(grid), smalldoku_uint8_t erase_count,
  */
 smalldoku_uint32_t smalldoku_solve_grid(SMALLDOKU_GRID(grid));
 
+/**
+ * Attempts to solve a grid, stopping as soon as the solution limit has been reached or the visitor requested to stop.
+ *
+ * @param grid the grid to solve
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended
+ */
+smalldoku_uint32_t smalldoku_solve_grid_bounded(SMALLDOKU_GRID(grid), const smalldoku_solve_options_t *options);
+
 /**
  * Retrieves the current value of a cell.
  *
@@ -108,3 +324,11 @@ smalldoku_uint32_t smalldoku_solve_grid(SMALLDOKU_GRID(grid));
  */
 smalldoku_uint8_t smalldoku_get_cell_value(SMALLDOKU_GRID(grid), smalldoku_uint8_t row, smalldoku_uint8_t col);
 
+/**
+ * Retrieves the current values of all cells.
+ *
+ * @param grid the grid to retrieve the values from
+ * @param digits buffer of SMALLDOKU_CELL_COUNT values to write the values to in row major order
+ */
+void smalldoku_get_grid_digits(SMALLDOKU_GRID(grid), smalldoku_uint8_t *digits);
+
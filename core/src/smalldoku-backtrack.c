@@ -0,0 +1,298 @@
+#include "smalldoku/smalldoku-backtrack.h"
+#include "smalldoku/smalldoku-memory.h"
+
+#include "smalldoku-grid-state.h"
+#include "smalldoku-search.h"
+#include "smalldoku-stats.h"
+
+/**
+ * Fills a cell and records it on the trail so it can be undone later.
+ *
+ * @param backtrack the solver to fill the cell in
+ * @param cell_index the index of the cell to fill
+ * @param number the number to fill the cell with
+ */
+static inline void search_place(
+        smalldoku_backtrack_t *backtrack,
+        smalldoku_cell_index_t cell_index,
+        smalldoku_uint8_t number
+) {
+    state_place(&backtrack->state, cell_index, number);
+    backtrack->trail[backtrack->trail_size++] = cell_index;
+}
+
+/**
+ * Empties all cells filled since the trail had the given size.
+ *
+ * @param backtrack the solver to undo the cells in
+ * @param trail_mark the trail size to return to
+ */
+static inline void search_undo(smalldoku_backtrack_t *backtrack, smalldoku_cell_index_t trail_mark) {
+    while (backtrack->trail_size > trail_mark) {
+        smalldoku_cell_index_t cell_index = backtrack->trail[--backtrack->trail_size];
+        state_remove(&backtrack->state, cell_index);
+    }
+}
+
+/**
+ * Repeatedly fills naked and hidden singles until no more can be found.
+ *
+ * @param backtrack the solver to propagate the singles in
+ * @return 0 if a contradiction has been found, 1 otherwise
+ */
+static int propagate_singles(smalldoku_backtrack_t *backtrack) {
+    smalldoku_grid_state_t *state = &backtrack->state;
+    const smalldoku_units_t *units = state->units;
+
+    int changed = 1;
+    while (changed && state->filled != SMALLDOKU_CELL_COUNT) {
+        changed = 0;
+
+        /* Naked singles, cells which can only take a single number */
+        for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+            if (state->cells[cell_index] != 0) {
+                continue;
+            }
+
+            number_mask_t candidates = state_candidates(state, cell_index);
+            STATS_ADD(backtrack->options->stats, candidate_checks, 1);
+
+            if (candidates == 0) {
+                return 0;
+            } else if ((candidates & (candidates - 1)) == 0) {
+                search_place(backtrack, cell_index, __builtin_ctz(candidates) + 1);
+                STATS_ADD(backtrack->options->stats, propagations, 1);
+                changed = 1;
+            }
+        }
+
+        /* Hidden singles, numbers which only fit into a single cell of a unit */
+        for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+            const smalldoku_cell_index_t *cells = units->cells[unit];
+            number_mask_t placed = 0;
+            number_mask_t once = 0;
+            number_mask_t twice = 0;
+
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                smalldoku_cell_index_t cell_index = cells[i];
+
+                if (state->cells[cell_index] != 0) {
+                    placed |= NUMBER_BIT(state->cells[cell_index]);
+                } else {
+                    number_mask_t candidates = state_candidates(state, cell_index);
+
+                    STATS_ADD(backtrack->options->stats, candidate_checks, 1);
+
+                    twice |= once & candidates;
+                    once |= candidates;
+                }
+            }
+
+            if ((once | placed) != ALL_NUMBERS_MASK) {
+                /* Some number does not fit anywhere in this unit */
+                return 0;
+            }
+
+            number_mask_t singles = once & ~twice;
+            while (singles) {
+                number_mask_t bit = singles & -singles;
+                singles ^= bit;
+
+                smalldoku_uint8_t i = 0;
+                for (; i < SMALLDOKU_GRID_WIDTH; i++) {
+                    smalldoku_cell_index_t cell_index = cells[i];
+
+                    if (state->cells[cell_index] == 0 && (state_candidates(state, cell_index) & bit)) {
+                        search_place(backtrack, cell_index, __builtin_ctz(bit) + 1);
+                        STATS_ADD(backtrack->options->stats, propagations, 1);
+                        break;
+                    }
+                }
+
+                if (i == SMALLDOKU_GRID_WIDTH) {
+                    /* The only cell the number fitted into has been taken by another single */
+                    return 0;
+                }
+
+                changed = 1;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Records the currently filled grid state as a solution.
+ *
+ * @param backtrack the solver which found the solution
+ * @return 1 if the search should continue, 0 otherwise
+ */
+static int report_solution(smalldoku_backtrack_t *backtrack) {
+    const smalldoku_solve_options_t *options = backtrack->options;
+
+    backtrack->solve_count++;
+
+    if (backtrack->solve_count == 1 && options->first_solution) {
+        smalldoku_memcpy(options->first_solution, backtrack->state.cells, SMALLDOKU_CELL_COUNT);
+    }
+
+    if (options->visitor && !options->visitor(backtrack->state.cells, options->visitor_data)) {
+        return 0;
+    }
+
+    return options->solution_limit == 0 || backtrack->solve_count < options->solution_limit;
+}
+
+/**
+ * Selects the empty cell to branch on next.
+ *
+ * @param backtrack the solver to select the cell for
+ * @param start_cell_index the index of the first cell which may be empty
+ * @return the index of the selected cell, or -1 if an empty cell without any candidates exists
+ */
+static int select_cell(smalldoku_backtrack_t *backtrack, smalldoku_cell_index_t start_cell_index) {
+    const smalldoku_grid_state_t *state = &backtrack->state;
+
+    if (backtrack->branching == SMALLDOKU_BRANCH_ROW_MAJOR) {
+        smalldoku_cell_index_t cell_index = start_cell_index;
+        while (state->cells[cell_index] != 0) {
+            cell_index++;
+        }
+
+        return cell_index;
+    }
+
+    int best_cell_index = -1;
+    smalldoku_uint8_t best_count = SMALLDOKU_GRID_WIDTH + 1;
+
+    for (smalldoku_cell_index_t cell_index = start_cell_index; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        if (state->cells[cell_index] != 0) {
+            continue;
+        }
+
+        smalldoku_uint8_t count = count_numbers(state_candidates(state, cell_index));
+        STATS_ADD(backtrack->options->stats, candidate_checks, 1);
+
+        if (count < best_count) {
+            if (count == 0) {
+                return -1;
+            }
+
+            best_cell_index = cell_index;
+            best_count = count;
+
+            if (count == 1) {
+                /* Can't get any better than a single candidate */
+                break;
+            }
+        }
+    }
+
+    return best_cell_index;
+}
+
+/**
+ * Enumerates the solutions of the loaded state using the decision stack of the solver.
+ *
+ * Every decision only remembers the cell it branched on, the numbers left to try and the trail size before the
+ * decision, so backtracking undoes exactly the cells filled since then instead of restoring a copy of the grid.
+ *
+ * @param backtrack the solver to enumerate the solutions for
+ * @return the reason the search ended
+ */
+static smalldoku_solve_status_t solve_grid_internal(smalldoku_backtrack_t *backtrack) {
+    smalldoku_grid_state_t *state = &backtrack->state;
+    smalldoku_cell_index_t depth = 0;
+    smalldoku_cell_index_t start_cell_index = 0;
+
+    while (1) {
+        /* Expand the current node: deduce what can be deduced, then either report it or push a decision */
+        if (backtrack->propagation == SMALLDOKU_PROPAGATE_NONE || propagate_singles(backtrack)) {
+            if (state->filled == SMALLDOKU_CELL_COUNT) {
+                if (!report_solution(backtrack)) {
+                    return SMALLDOKU_SOLVE_STOPPED;
+                }
+
+                STATS_ADD(backtrack->options->stats, backtracks, 1);
+            } else {
+                int cell_index = select_cell(backtrack, start_cell_index);
+
+                if (cell_index >= 0) {
+                    smalldoku_backtrack_frame_t *frame = &backtrack->frames[depth++];
+
+                    frame->cell_index = cell_index;
+                    frame->trail_mark = backtrack->trail_size;
+                    frame->remaining = state_candidates(state, cell_index);
+                    STATS_ADD(backtrack->options->stats, candidate_checks, 1);
+                    STATS_MAX(backtrack->options->stats, max_depth, depth);
+                } else {
+                    STATS_ADD(backtrack->options->stats, backtracks, 1);
+                }
+            }
+        } else {
+            STATS_ADD(backtrack->options->stats, backtracks, 1);
+        }
+
+        /* Drop the decisions which have no numbers left to try */
+        while (depth > 0 && backtrack->frames[depth - 1].remaining == 0) {
+            depth--;
+        }
+
+        if (depth == 0) {
+            return SMALLDOKU_SOLVE_COMPLETE;
+        }
+
+        smalldoku_solve_status_t status = search_check_limits(backtrack->options, backtrack->node_count);
+        if (status != SMALLDOKU_SOLVE_COMPLETE) {
+            return status;
+        }
+
+        smalldoku_backtrack_frame_t *frame = &backtrack->frames[depth - 1];
+        search_undo(backtrack, frame->trail_mark);
+
+        number_mask_t bit = frame->remaining & -frame->remaining;
+        frame->remaining ^= bit;
+
+        search_place(backtrack, frame->cell_index, __builtin_ctz(bit) + 1);
+        backtrack->node_count++;
+        STATS_ADD(backtrack->options->stats, nodes, 1);
+
+        /* Cells are only filled in order when branching row major, otherwise every cell needs to be considered again */
+        start_cell_index = backtrack->branching == SMALLDOKU_BRANCH_ROW_MAJOR ? frame->cell_index + 1 : 0;
+    }
+}
+
+void smalldoku_backtrack_init(
+        smalldoku_backtrack_t *backtrack,
+        const smalldoku_units_t *units,
+        smalldoku_branching_t branching,
+        smalldoku_propagation_t propagation
+) {
+    backtrack->state.units = units;
+    backtrack->branching = branching;
+    backtrack->propagation = propagation;
+    backtrack->trail_size = 0;
+}
+
+smalldoku_uint32_t smalldoku_backtrack_solve_digits(
+        smalldoku_backtrack_t *backtrack,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+) {
+    backtrack->options = options;
+    backtrack->solve_count = 0;
+    backtrack->node_count = 0;
+    backtrack->trail_size = 0;
+    STATS_ADD(options->stats, solve_calls, 1);
+
+    /* If the given numbers already contradict each other there is no solution to search for */
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+    if (state_load(&backtrack->state, backtrack->state.units, digits)) {
+        status = solve_grid_internal(backtrack);
+    }
+
+    search_finish(options, status, backtrack->node_count);
+
+    return backtrack->solve_count;
+}
@@ -0,0 +1,195 @@
+#include "smalldoku/smalldoku-bank.h"
+
+#include "smalldoku/smalldoku-memory.h"
+#include "smalldoku/smalldoku-rng.h"
+
+/**
+ * The offset of the entries from the start of a bank.
+ */
+#define ENTRIES_OFFSET ((sizeof(smalldoku_bank_header_t) + 7) & ~(smalldoku_uint64_t) 7)
+
+/**
+ * The mask selecting a single packed number.
+ */
+#define NUMBER_MASK ((1U << SMALLDOKU_BANK_NUMBER_BITS) - 1)
+
+smalldoku_uint64_t smalldoku_bank_size(smalldoku_uint32_t entry_count) {
+    return ENTRIES_OFFSET + (smalldoku_uint64_t) entry_count * sizeof(smalldoku_bank_entry_t);
+}
+
+void smalldoku_bank_build(void *buffer, const smalldoku_bank_entry_t *entries, smalldoku_uint32_t entry_count) {
+    smalldoku_bank_header_t *header = buffer;
+    smalldoku_bank_entry_t *target = (smalldoku_bank_entry_t *) ((smalldoku_uint8_t *) buffer + ENTRIES_OFFSET);
+
+    for (smalldoku_uint8_t i = 0; i < 4; i++) {
+        header->magic[i] = SMALLDOKU_BANK_MAGIC[i];
+    }
+
+    header->version = SMALLDOKU_BANK_VERSION;
+    header->entry_size = sizeof(smalldoku_bank_entry_t);
+    header->grid_width = SMALLDOKU_GRID_WIDTH;
+    header->grid_height = SMALLDOKU_GRID_HEIGHT;
+    header->reserved = 0;
+    header->entry_count = entry_count;
+
+    /* Counting sort: count every clue count, turn the counts into start indices and place the entries */
+    for (smalldoku_uint32_t clues = 0; clues < SMALLDOKU_CELL_COUNT + 2; clues++) {
+        header->clue_index[clues] = 0;
+    }
+
+    for (smalldoku_uint32_t i = 0; i < entry_count; i++) {
+        header->clue_index[entries[i].clue_count + 1]++;
+    }
+
+    for (smalldoku_uint32_t clues = 1; clues < SMALLDOKU_CELL_COUNT + 2; clues++) {
+        header->clue_index[clues] += header->clue_index[clues - 1];
+    }
+
+    for (smalldoku_uint32_t i = 0; i < entry_count; i++) {
+        smalldoku_bank_entry_t *placed = &target[header->clue_index[entries[i].clue_count]++];
+        smalldoku_memcpy(placed, &entries[i], sizeof(smalldoku_bank_entry_t));
+    }
+
+    /* Placing advanced every start index to the start of the next clue count */
+    for (smalldoku_uint32_t clues = SMALLDOKU_CELL_COUNT + 1; clues > 0; clues--) {
+        header->clue_index[clues] = header->clue_index[clues - 1];
+    }
+
+    header->clue_index[0] = 0;
+}
+
+smalldoku_bank_status_t smalldoku_bank_open(smalldoku_bank_t *bank, const void *data, smalldoku_uint64_t size) {
+    const smalldoku_bank_header_t *header = data;
+
+    if (size < ENTRIES_OFFSET) {
+        return SMALLDOKU_BANK_TRUNCATED;
+    }
+
+    for (smalldoku_uint8_t i = 0; i < 4; i++) {
+        if (header->magic[i] != (smalldoku_uint8_t) SMALLDOKU_BANK_MAGIC[i]) {
+            return SMALLDOKU_BANK_BAD_MAGIC;
+        }
+    }
+
+    if (
+            header->version != SMALLDOKU_BANK_VERSION ||
+            header->entry_size != sizeof(smalldoku_bank_entry_t) ||
+            header->grid_width != SMALLDOKU_GRID_WIDTH ||
+            header->grid_height != SMALLDOKU_GRID_HEIGHT
+    ) {
+        return SMALLDOKU_BANK_UNSUPPORTED;
+    }
+
+    if (size < smalldoku_bank_size(header->entry_count)) {
+        return SMALLDOKU_BANK_TRUNCATED;
+    }
+
+    /* Validating the index once lets lookups trust it without any further checks */
+    if (header->clue_index[0] != 0 || header->clue_index[SMALLDOKU_CELL_COUNT + 1] != header->entry_count) {
+        return SMALLDOKU_BANK_BAD_INDEX;
+    }
+
+    for (smalldoku_uint32_t clues = 1; clues < SMALLDOKU_CELL_COUNT + 2; clues++) {
+        if (header->clue_index[clues] < header->clue_index[clues - 1]) {
+            return SMALLDOKU_BANK_BAD_INDEX;
+        }
+    }
+
+    bank->header = header;
+    bank->entries = (const smalldoku_bank_entry_t *) ((const smalldoku_uint8_t *) data + ENTRIES_OFFSET);
+
+    return SMALLDOKU_BANK_OK;
+}
+
+smalldoku_uint32_t smalldoku_bank_count(
+        const smalldoku_bank_t *bank,
+        smalldoku_cell_index_t min_clues,
+        smalldoku_cell_index_t max_clues
+) {
+    if (min_clues > max_clues || min_clues > SMALLDOKU_CELL_COUNT) {
+        return 0;
+    }
+
+    if (max_clues > SMALLDOKU_CELL_COUNT) {
+        max_clues = SMALLDOKU_CELL_COUNT;
+    }
+
+    return bank->header->clue_index[max_clues + 1] - bank->header->clue_index[min_clues];
+}
+
+const smalldoku_bank_entry_t *smalldoku_bank_pick(
+        const smalldoku_bank_t *bank,
+        smalldoku_cell_index_t min_clues,
+        smalldoku_cell_index_t max_clues,
+        smalldoku_rng_t *rng
+) {
+    smalldoku_uint32_t count = smalldoku_bank_count(bank, min_clues, max_clues);
+    if (count == 0) {
+        return 0;
+    }
+
+    /* smalldoku_rng_range only covers 65536 values, so 32 random bits are scaled to the count instead */
+    smalldoku_uint64_t offset = (smalldoku_rng_next(rng) >> 32) * count >> 32;
+
+    return &bank->entries[bank->header->clue_index[min_clues] + offset];
+}
+
+void smalldoku_bank_entry_pack(
+        smalldoku_bank_entry_t *entry,
+        const smalldoku_uint8_t *puzzle,
+        const smalldoku_uint8_t *solution,
+        smalldoku_uint8_t difficulty
+) {
+    for (smalldoku_uint8_t word = 0; word < SMALLDOKU_CELL_SET_WORDS; word++) {
+        entry->given[word] = 0;
+    }
+
+    for (smalldoku_uint32_t i = 0; i < SMALLDOKU_BANK_SOLUTION_BYTES; i++) {
+        entry->solution[i] = 0;
+    }
+
+    entry->clue_count = 0;
+    entry->difficulty = difficulty;
+
+    for (smalldoku_uint32_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint32_t bit = cell_index * SMALLDOKU_BANK_NUMBER_BITS;
+        entry->solution[bit / 8] |= (smalldoku_uint8_t) ((solution[cell_index] - 1) << (bit % 8));
+
+        if (puzzle[cell_index] != 0) {
+            entry->given[cell_index / 64] |= 1UL << (cell_index % 64);
+            entry->clue_count++;
+        }
+    }
+}
+
+void smalldoku_bank_entry_unpack(
+        const smalldoku_bank_entry_t *entry,
+        smalldoku_uint8_t *puzzle,
+        smalldoku_uint8_t *solution
+) {
+    for (smalldoku_uint32_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint32_t bit = cell_index * SMALLDOKU_BANK_NUMBER_BITS;
+        smalldoku_uint8_t number = ((entry->solution[bit / 8] >> (bit % 8)) & NUMBER_MASK) + 1;
+
+        if (puzzle) {
+            puzzle[cell_index] = smalldoku_cell_set_has(entry->given, cell_index) ? number : 0;
+        }
+
+        if (solution) {
+            solution[cell_index] = number;
+        }
+    }
+}
+
+void smalldoku_bank_entry_to_grid(const smalldoku_bank_entry_t *entry, SMALLDOKU_GRID(grid)) {
+    smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+    smalldoku_bank_entry_unpack(entry, 0, solution);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        cell->type = smalldoku_cell_set_has(entry->given, cell_index) ? SMALLDOKU_GENERATED_CELL : SMALLDOKU_USER_CELL;
+        cell->value = solution[cell_index];
+        cell->user_value = 0;
+    }
+}
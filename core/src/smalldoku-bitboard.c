@@ -0,0 +1,429 @@
+#include "smalldoku/smalldoku-bitboard.h"
+#include "smalldoku/smalldoku-memory.h"
+
+#include "smalldoku-search.h"
+#include "smalldoku-stats.h"
+
+typedef smalldoku_bitboard_t board_t;
+
+/*
+ * The board operations either use the vector extensions of the compiler, which compile down to single SSE
+ * instructions, or operate on the lanes one after another. Define SMALLDOKU_BITBOARD_SCALAR to force the latter.
+ */
+#if defined(__SSE2__) && !defined(SMALLDOKU_BITBOARD_SCALAR)
+
+static inline board_t board_and(board_t a, board_t b) {
+    return a & b;
+}
+
+static inline board_t board_or(board_t a, board_t b) {
+    return a | b;
+}
+
+static inline board_t board_and_not(board_t a, board_t b) {
+    return a & ~b;
+}
+
+#else
+
+static inline board_t board_and(board_t a, board_t b) {
+    board_t result;
+    for (int lane = 0; lane < SMALLDOKU_BITBOARD_LANES; lane++) {
+        result[lane] = a[lane] & b[lane];
+    }
+    return result;
+}
+
+static inline board_t board_or(board_t a, board_t b) {
+    board_t result;
+    for (int lane = 0; lane < SMALLDOKU_BITBOARD_LANES; lane++) {
+        result[lane] = a[lane] | b[lane];
+    }
+    return result;
+}
+
+static inline board_t board_and_not(board_t a, board_t b) {
+    board_t result;
+    for (int lane = 0; lane < SMALLDOKU_BITBOARD_LANES; lane++) {
+        result[lane] = a[lane] & ~b[lane];
+    }
+    return result;
+}
+
+#endif
+
+/**
+ * Creates a board containing a single cell.
+ *
+ * @param cell_index the index of the cell in row major order
+ * @return the created board
+ */
+static inline board_t board_cell(smalldoku_cell_index_t cell_index) {
+    board_t result = {0};
+    result[cell_index / 64] = 1UL << (cell_index % 64);
+    return result;
+}
+
+/**
+ * Determines whether a board does not contain any cells.
+ *
+ * @param board the board to check
+ * @return 1 if the board is empty, 0 otherwise
+ */
+static inline int board_empty(board_t board) {
+    smalldoku_uint64_t bits = board[0];
+    for (int lane = 1; lane < SMALLDOKU_BITBOARD_LANES; lane++) {
+        bits |= board[lane];
+    }
+    return bits == 0;
+}
+
+/**
+ * Determines whether a board contains exactly one cell.
+ *
+ * @param board the board to check
+ * @return 1 if exactly one cell is contained, 0 otherwise
+ */
+static inline int board_single(board_t board) {
+    int found = 0;
+
+    for (int lane = 0; lane < SMALLDOKU_BITBOARD_LANES; lane++) {
+        smalldoku_uint64_t bits = board[lane];
+
+        if (bits) {
+            if (found || (bits & (bits - 1)) != 0) {
+                return 0;
+            }
+
+            found = 1;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Retrieves the lowest cell of a non-empty board.
+ *
+ * @param board the board to retrieve the cell from
+ * @return the index of the cell in row major order
+ */
+static inline smalldoku_cell_index_t board_first(board_t board) {
+    int lane = 0;
+    while (board[lane] == 0) {
+        lane++;
+    }
+
+    return lane * 64 + __builtin_ctzl(board[lane]);
+}
+
+/**
+ * Determines whether a board contains a cell.
+ *
+ * @param board the board to check
+ * @param cell_index the index of the cell in row major order
+ * @return 1 if the cell is contained, 0 otherwise
+ */
+static inline int board_has(board_t board, smalldoku_cell_index_t cell_index) {
+    return (board[cell_index / 64] >> (cell_index % 64)) & 1;
+}
+
+/**
+ * Places a number into a cell and removes it from the candidates of all peers.
+ *
+ * @param solver the solver to look up the peers with
+ * @param state the state to place the number on
+ * @param cell_index the index of the cell in row major order
+ * @param number the number to place
+ */
+static void place(
+        const smalldoku_bitboard_solver_t *solver,
+        smalldoku_bitboard_state_t *state,
+        smalldoku_cell_index_t cell_index,
+        smalldoku_uint8_t number
+) {
+    board_t cell = board_cell(cell_index);
+
+    for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+        state->candidates[n] = board_and_not(state->candidates[n], cell);
+    }
+
+    state->candidates[number - 1] = board_or(
+            board_and_not(state->candidates[number - 1], solver->peers[cell_index]),
+            cell
+    );
+    state->solved = board_or(state->solved, cell);
+}
+
+/**
+ * Repeatedly places naked and hidden singles until no more can be found.
+ *
+ * @param solver the solver to look up the tables with
+ * @param state the state to propagate the singles in
+ * @param stats the statistics to update, or NULL
+ * @return 0 if a contradiction has been found, 1 otherwise
+ */
+static int propagate(
+        const smalldoku_bitboard_solver_t *solver,
+        smalldoku_bitboard_state_t *state,
+        smalldoku_stats_t *stats
+) {
+    while (1) {
+        board_t unsolved = board_and_not(solver->all, state->solved);
+        if (board_empty(unsolved)) {
+            return 1;
+        }
+
+        /* Count the candidates of all cells at once, saturating at two */
+        board_t once = {0};
+        board_t twice = {0};
+        for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+            board_t open = board_and(state->candidates[n], unsolved);
+            twice = board_or(twice, board_and(once, open));
+            once = board_or(once, open);
+        }
+        STATS_ADD(stats, candidate_checks, SMALLDOKU_GRID_WIDTH);
+
+        if (!board_empty(board_and_not(unsolved, once))) {
+            /* Some cell has no candidates left */
+            return 0;
+        }
+
+        board_t singles = board_and_not(once, twice);
+        if (!board_empty(singles)) {
+            for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+                board_t cells = board_and(state->candidates[n], singles);
+
+                while (!board_empty(cells)) {
+                    smalldoku_cell_index_t cell_index = board_first(cells);
+                    cells = board_and_not(cells, board_cell(cell_index));
+
+                    /* A previously placed single may have taken the number from this cell, which is detected as an
+                     * empty cell in the next round */
+                    if (board_has(state->candidates[n], cell_index)) {
+                        place(solver, state, cell_index, n + 1);
+                        STATS_ADD(stats, propagations, 1);
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        int found = 0;
+        smalldoku_uint8_t unit_count = solver->unit_count;
+        for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+            for (smalldoku_uint8_t unit = 0; unit < unit_count; unit++) {
+                board_t cells = board_and(state->candidates[n], solver->units[unit]);
+                STATS_ADD(stats, candidate_checks, 1);
+
+                if (!board_empty(board_and(cells, state->solved))) {
+                    /* The number has already been placed in this unit */
+                    continue;
+                }
+
+                if (board_empty(cells)) {
+                    return 0;
+                }
+
+                if (board_single(cells)) {
+                    place(solver, state, board_first(cells), n + 1);
+                    STATS_ADD(stats, propagations, 1);
+                    found = 1;
+                }
+            }
+        }
+
+        if (!found) {
+            return 1;
+        }
+    }
+}
+
+/**
+ * Selects the unsolved cell with the fewest candidates.
+ *
+ * @param solver the solver to look up the tables with
+ * @param state the propagated state to select the cell from, must contain unsolved cells
+ * @param candidates pointer to write the candidate numbers of the cell to
+ * @param stats the statistics to update, or NULL
+ * @return the index of the cell in row major order
+ */
+static smalldoku_cell_index_t select_cell(
+        const smalldoku_bitboard_solver_t *solver,
+        const smalldoku_bitboard_state_t *state,
+        smalldoku_number_mask_t *candidates,
+        smalldoku_stats_t *stats
+) {
+    board_t unsolved = board_and_not(solver->all, state->solved);
+
+    /* After propagation no cell has a single candidate left, so look for cells with exactly two first */
+    board_t once = {0};
+    board_t twice = {0};
+    board_t thrice = {0};
+    for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+        board_t open = board_and(state->candidates[n], unsolved);
+        thrice = board_or(thrice, board_and(twice, open));
+        twice = board_or(twice, board_and(once, open));
+        once = board_or(once, open);
+    }
+
+    board_t pairs = board_and_not(twice, thrice);
+    smalldoku_cell_index_t best_cell_index;
+
+    if (!board_empty(pairs)) {
+        best_cell_index = board_first(pairs);
+    } else {
+        smalldoku_uint8_t best_count = SMALLDOKU_GRID_WIDTH + 1;
+        best_cell_index = board_first(unsolved);
+
+        while (!board_empty(unsolved)) {
+            smalldoku_cell_index_t cell_index = board_first(unsolved);
+            unsolved = board_and_not(unsolved, board_cell(cell_index));
+
+            smalldoku_uint8_t count = 0;
+            for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+                count += board_has(state->candidates[n], cell_index);
+            }
+            STATS_ADD(stats, candidate_checks, 1);
+
+            if (count < best_count) {
+                best_count = count;
+                best_cell_index = cell_index;
+            }
+        }
+    }
+
+    *candidates = 0;
+    for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+        if (board_has(state->candidates[n], best_cell_index)) {
+            *candidates |= 1ul << n;
+        }
+    }
+
+    return best_cell_index;
+}
+
+void smalldoku_bitboard_init(smalldoku_bitboard_solver_t *solver, const smalldoku_units_t *units) {
+    board_t empty = {0};
+    solver->all = empty;
+    solver->unit_count = units->unit_count;
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        solver->units[unit] = empty;
+
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            solver->units[unit] = board_or(solver->units[unit], board_cell(units->cells[unit][i]));
+        }
+    }
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        solver->all = board_or(solver->all, board_cell(cell_index));
+        solver->peers[cell_index] = empty;
+
+        for (smalldoku_uint8_t i = 0; i < units->peer_count[cell_index]; i++) {
+            solver->peers[cell_index] = board_or(solver->peers[cell_index], board_cell(units->peers[cell_index][i]));
+        }
+    }
+}
+
+smalldoku_uint32_t smalldoku_bitboard_solve_digits(
+        smalldoku_bitboard_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+) {
+    smalldoku_uint32_t solve_count = 0;
+    smalldoku_uint64_t node_count = 0;
+
+    smalldoku_bitboard_state_t state;
+    for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+        state.candidates[n] = solver->all;
+    }
+    state.solved = board_and_not(solver->all, solver->all);
+
+    int consistent = 1;
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT && consistent; cell_index++) {
+        smalldoku_uint8_t number = digits[cell_index];
+
+        if (number == 0) {
+            continue;
+        }
+
+        if (board_has(state.solved, cell_index) || !board_has(state.candidates[number - 1], cell_index)) {
+            consistent = 0;
+        } else {
+            place(solver, &state, cell_index, number);
+        }
+    }
+
+    smalldoku_cell_index_t depth = 0;
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+    STATS_ADD(options->stats, solve_calls, 1);
+
+    while (consistent) {
+        if (propagate(solver, &state, options->stats)) {
+            if (board_empty(board_and_not(solver->all, state.solved))) {
+                solve_count++;
+
+                for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+                    board_t cells = state.candidates[n];
+
+                    while (!board_empty(cells)) {
+                        smalldoku_cell_index_t cell_index = board_first(cells);
+                        cells = board_and_not(cells, board_cell(cell_index));
+                        solver->cells[cell_index] = n + 1;
+                    }
+                }
+
+                if (solve_count == 1 && options->first_solution) {
+                    smalldoku_memcpy(options->first_solution, solver->cells, SMALLDOKU_CELL_COUNT);
+                }
+
+                if (options->visitor && !options->visitor(solver->cells, options->visitor_data)) {
+                    status = SMALLDOKU_SOLVE_STOPPED;
+                    break;
+                }
+
+                if (options->solution_limit != 0 && solve_count >= options->solution_limit) {
+                    status = SMALLDOKU_SOLVE_STOPPED;
+                    break;
+                }
+
+                STATS_ADD(options->stats, backtracks, 1);
+            } else {
+                smalldoku_bitboard_frame_t *frame = &solver->frames[depth++];
+                frame->state = state;
+                frame->cell_index = select_cell(solver, &state, &frame->remaining, options->stats);
+                STATS_MAX(options->stats, max_depth, depth);
+            }
+        } else {
+            STATS_ADD(options->stats, backtracks, 1);
+        }
+
+        /* Continue with the next untried number of the latest decision */
+        while (depth > 0 && solver->frames[depth - 1].remaining == 0) {
+            depth--;
+        }
+
+        if (depth == 0) {
+            break;
+        }
+
+        status = search_check_limits(options, node_count);
+        if (status != SMALLDOKU_SOLVE_COMPLETE) {
+            break;
+        }
+
+        smalldoku_bitboard_frame_t *frame = &solver->frames[depth - 1];
+        smalldoku_uint8_t n = __builtin_ctz(frame->remaining);
+        frame->remaining &= frame->remaining - 1;
+
+        state = frame->state;
+        place(solver, &state, frame->cell_index, n + 1);
+        node_count++;
+        STATS_ADD(options->stats, nodes, 1);
+    }
+
+    search_finish(options, status, node_count);
+    return solve_count;
+}
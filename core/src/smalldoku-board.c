@@ -0,0 +1,74 @@
+#include "smalldoku/smalldoku-board.h"
+
+/**
+ * Adds a cell to or removes a cell from a cell set.
+ *
+ * @param set the set to modify
+ * @param cell_index the index of the cell in row major order
+ * @param contained 1 to add the cell, 0 to remove it
+ */
+static inline void cell_set_put(smalldoku_uint64_t *set, smalldoku_cell_index_t cell_index, int contained) {
+    smalldoku_uint64_t bit = (smalldoku_uint64_t) 1 << (cell_index % 64);
+
+    if (contained) {
+        set[cell_index / 64] |= bit;
+    } else {
+        set[cell_index / 64] &= ~bit;
+    }
+}
+
+void smalldoku_board_clear(smalldoku_board_t *board) {
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        board->digits[i] = 0;
+    }
+
+    for (smalldoku_uint8_t i = 0; i < SMALLDOKU_CELL_SET_WORDS; i++) {
+        board->given[i] = 0;
+        board->user[i] = 0;
+    }
+}
+
+void smalldoku_board_set_given(smalldoku_board_t *board, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number) {
+    board->digits[cell_index] = number;
+    cell_set_put(board->given, cell_index, number != 0);
+    cell_set_put(board->user, cell_index, 0);
+}
+
+void smalldoku_board_set_user(smalldoku_board_t *board, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number) {
+    if (smalldoku_cell_set_has(board->given, cell_index)) {
+        return;
+    }
+
+    board->digits[cell_index] = number;
+    cell_set_put(board->user, cell_index, number != 0);
+}
+
+void smalldoku_board_from_grid(smalldoku_board_t *board, SMALLDOKU_GRID(grid)) {
+    smalldoku_board_clear(board);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        if (cell->type == SMALLDOKU_GENERATED_CELL) {
+            smalldoku_board_set_given(board, cell_index, cell->value);
+        } else {
+            smalldoku_board_set_user(board, cell_index, cell->user_value);
+        }
+    }
+}
+
+void smalldoku_board_to_grid(const smalldoku_board_t *board, const smalldoku_uint8_t *solution, SMALLDOKU_GRID(grid)) {
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        if (smalldoku_cell_set_has(board->given, cell_index)) {
+            cell->type = SMALLDOKU_GENERATED_CELL;
+            cell->value = board->digits[cell_index];
+            cell->user_value = 0;
+        } else {
+            cell->type = SMALLDOKU_USER_CELL;
+            cell->value = solution ? solution[cell_index] : 0;
+            cell->user_value = board->digits[cell_index];
+        }
+    }
+}
@@ -0,0 +1,435 @@
+#include "smalldoku/smalldoku-canonical.h"
+#include "smalldoku/smalldoku-memory.h"
+
+#define BAND_COUNT (SMALLDOKU_GRID_HEIGHT / SMALLDOKU_SQUARE_HEIGHT)
+#define STACK_COUNT (SMALLDOKU_GRID_WIDTH / SMALLDOKU_SQUARE_WIDTH)
+
+/* Transposing swaps bands and stacks, which is only valid if squares are square */
+#if SMALLDOKU_SQUARE_WIDTH == SMALLDOKU_SQUARE_HEIGHT
+#define ORIENTATION_COUNT 2
+#else
+#define ORIENTATION_COUNT 1
+#endif
+
+/* The second row of the transformed grid has to come from the band of the first one */
+#define PAIR_COUNT (SMALLDOKU_GRID_HEIGHT * (SMALLDOKU_SQUARE_HEIGHT - 1))
+#define UNPLACED 0xFF
+
+/**
+ * State of the search for the canonical transformation.
+ */
+struct canonical_search {
+    /**
+     * The solution in the orientation currently searched.
+     */
+    const smalldoku_uint8_t *solution;
+
+    /**
+     * The puzzle in the orientation currently searched.
+     */
+    const smalldoku_uint8_t *puzzle;
+
+    /**
+     * The source column of every column of the transformed grid.
+     */
+    smalldoku_uint8_t cols[SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * The column of the transformed grid of every source column, UNPLACED if it has not been chosen yet.
+     */
+    smalldoku_uint8_t positions[SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * For every pair of source rows that may become the first two rows, the column of the first row that holds the
+     * number of every column of the second row.
+     */
+    smalldoku_uint8_t pairs[PAIR_COUNT][SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * The source row of every row of the transformed grid chosen so far.
+     */
+    smalldoku_uint8_t rows[SMALLDOKU_GRID_HEIGHT];
+
+    /**
+     * The new label of every number, fixed by the first row, with 0 staying 0.
+     */
+    smalldoku_uint8_t labels[SMALLDOKU_GRID_WIDTH + 1];
+
+    /**
+     * The transformed solution rows chosen so far.
+     */
+    smalldoku_uint8_t current[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The smallest transformed solution found so far.
+     */
+    smalldoku_uint8_t best_solution[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The transformed puzzle belonging to best_solution.
+     */
+    smalldoku_uint8_t best_puzzle[SMALLDOKU_CELL_COUNT];
+};
+
+typedef struct canonical_search canonical_search_t;
+
+/**
+ * Compares two arrays of values lexicographically.
+ *
+ * @param a the first array
+ * @param b the second array
+ * @param count the amount of values to compare
+ * @return a negative value if a is smaller, a positive value if a is larger and 0 if both are equal
+ */
+static int compare_values(const smalldoku_uint8_t *a, const smalldoku_uint8_t *b, smalldoku_cell_index_t count) {
+    for (smalldoku_cell_index_t i = 0; i < count; i++) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Writes the puzzle transformed by the rows, columns and labels of a search.
+ *
+ * @param search the search whose transformation to apply
+ * @param out buffer of SMALLDOKU_CELL_COUNT values to write the transformed puzzle to
+ */
+static void transform_puzzle(const canonical_search_t *search, smalldoku_uint8_t *out) {
+    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
+        const smalldoku_uint8_t *source = &search->puzzle[search->rows[row] * SMALLDOKU_GRID_WIDTH];
+
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            out[row * SMALLDOKU_GRID_WIDTH + col] = search->labels[source[search->cols[col]]];
+        }
+    }
+}
+
+/**
+ * Handles a complete transformation, keeping it if it beats the best one found so far.
+ *
+ * @param search the search the transformation belongs to
+ * @param less whether the transformed solution is smaller than the best one
+ */
+static void finish_transformation(canonical_search_t *search, int less) {
+    if (less) {
+        smalldoku_memcpy(search->best_solution, search->current, SMALLDOKU_CELL_COUNT);
+
+        transform_puzzle(search, search->best_puzzle);
+        return;
+    }
+
+    /* The solution is the same, so the transformation is an automorphism of the best one and the puzzle decides */
+    smalldoku_uint8_t puzzle[SMALLDOKU_CELL_COUNT];
+    transform_puzzle(search, puzzle);
+
+    if (compare_values(puzzle, search->best_puzzle, SMALLDOKU_CELL_COUNT) < 0) {
+        smalldoku_memcpy(search->best_puzzle, puzzle, SMALLDOKU_CELL_COUNT);
+    }
+}
+
+/**
+ * Tries all row orders for the current columns.
+ *
+ * The first row is relabeled to 1, 2, 3, ... so every source row ties as the first one and each is tried. Below it the
+ * search is greedy: two rows of a solution differ in every column, so exactly one candidate gives the smallest next
+ * row and any other choice leads to a larger solution. The first row of every band may come from any unused band, the
+ * other rows have to come from the same band.
+ *
+ * @param search the search to continue
+ */
+static void search_rows(canonical_search_t *search) {
+    for (smalldoku_uint8_t first_row = 0; first_row < SMALLDOKU_GRID_HEIGHT; first_row++) {
+        const smalldoku_uint8_t *source = &search->solution[first_row * SMALLDOKU_GRID_WIDTH];
+
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            search->labels[source[search->cols[col]]] = col + 1;
+            search->current[col] = col + 1;
+        }
+
+        search->rows[0] = first_row;
+
+        smalldoku_uint32_t used = 1U << first_row;
+        int less = 0;
+        smalldoku_uint8_t depth = 1;
+
+        for (; depth < SMALLDOKU_GRID_HEIGHT; depth++) {
+            smalldoku_uint8_t first = 0;
+            smalldoku_uint8_t last = SMALLDOKU_GRID_HEIGHT;
+
+            if (depth % SMALLDOKU_SQUARE_HEIGHT != 0) {
+                first = search->rows[depth - 1] / SMALLDOKU_SQUARE_HEIGHT * SMALLDOKU_SQUARE_HEIGHT;
+                last = first + SMALLDOKU_SQUARE_HEIGHT;
+            }
+
+            smalldoku_uint8_t *row = &search->current[depth * SMALLDOKU_GRID_WIDTH];
+            smalldoku_uint8_t smallest = UNPLACED;
+
+            for (smalldoku_uint8_t source_row = first; source_row < last; source_row++) {
+                if (used & (1U << source_row)) {
+                    continue;
+                }
+
+                source = &search->solution[source_row * SMALLDOKU_GRID_WIDTH];
+
+                /* Most candidates lose within the first few cells, so the row is compared while it is transformed */
+                smalldoku_uint8_t col = 0;
+
+                if (smallest != UNPLACED) {
+                    while (col < SMALLDOKU_GRID_WIDTH && search->labels[source[search->cols[col]]] == row[col]) {
+                        col++;
+                    }
+
+                    if (col == SMALLDOKU_GRID_WIDTH || search->labels[source[search->cols[col]]] > row[col]) {
+                        continue;
+                    }
+                }
+
+                for (; col < SMALLDOKU_GRID_WIDTH; col++) {
+                    row[col] = search->labels[source[search->cols[col]]];
+                }
+
+                smallest = source_row;
+            }
+
+            if (!less) {
+                const smalldoku_uint8_t *best = &search->best_solution[depth * SMALLDOKU_GRID_WIDTH];
+                int order = compare_values(row, best, SMALLDOKU_GRID_WIDTH);
+
+                if (order > 0) {
+                    break;
+                }
+
+                less = order < 0;
+            }
+
+            search->rows[depth] = smallest;
+            used |= 1U << smallest;
+        }
+
+        if (depth == SMALLDOKU_GRID_HEIGHT) {
+            finish_transformation(search, less);
+        }
+    }
+}
+
+/**
+ * Checks whether a pair of first rows may still lead to a solution no larger than the best one.
+ *
+ * After relabeling, the first row is always 1, 2, 3, ... so the second row decides. Its number in a column is the
+ * transformed position of the column of the first row holding the same number. That position is only known once the
+ * column has been chosen, before that it is at least the next free position of its stack.
+ *
+ * @param search the search whose column order to check
+ * @param pair the pair of rows to check, see canonical_search.pairs
+ * @param depth the amount of columns chosen so far, at least 1
+ * @return 1 if the transformed second row may be smaller or equal to the best one, 0 if it is known to be larger
+ */
+static int pair_may_win(const canonical_search_t *search, const smalldoku_uint8_t *pair, smalldoku_uint8_t depth) {
+    const smalldoku_uint8_t *best = &search->best_solution[SMALLDOKU_GRID_WIDTH];
+    smalldoku_uint8_t stack = search->cols[depth - 1] / SMALLDOKU_SQUARE_WIDTH;
+    smalldoku_uint8_t next_stack = (depth + SMALLDOKU_SQUARE_WIDTH - 1) / SMALLDOKU_SQUARE_WIDTH;
+    next_stack *= SMALLDOKU_SQUARE_WIDTH;
+
+    for (smalldoku_uint8_t col = 0; col < depth; col++) {
+        smalldoku_uint8_t target = pair[search->cols[col]];
+        smalldoku_uint8_t position = search->positions[target];
+        int exact = position != UNPLACED;
+
+        if (!exact) {
+            position = target / SMALLDOKU_SQUARE_WIDTH == stack ? depth : next_stack;
+        }
+
+        if (position + 1 != best[col]) {
+            return position + 1 < best[col];
+        }
+
+        if (!exact) {
+            return 1;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Tries all column orders for the current orientation, starting at a column of the transformed grid.
+ *
+ * The first column of every stack may come from any unused stack, the other columns have to come from the same
+ * stack. Column orders are dropped as soon as the second row can no longer beat the best solution for any pair of
+ * first rows, the remaining ones are completed by search_rows. The recursion depth is bounded by SMALLDOKU_GRID_WIDTH.
+ *
+ * @param search the search to continue
+ * @param depth the column of the transformed grid to choose a source column for
+ * @param used the source columns chosen so far, one bit per column
+ * @param alive the pairs of first rows that may still beat the best solution
+ * @param alive_count the amount of pairs in alive
+ */
+static void search_columns(
+        canonical_search_t *search,
+        smalldoku_uint8_t depth,
+        smalldoku_uint32_t used,
+        const smalldoku_uint8_t *alive,
+        smalldoku_uint8_t alive_count
+) {
+    if (depth == SMALLDOKU_GRID_WIDTH) {
+        search_rows(search);
+        return;
+    }
+
+    smalldoku_uint8_t first = 0;
+    smalldoku_uint8_t last = SMALLDOKU_GRID_WIDTH;
+
+    if (depth % SMALLDOKU_SQUARE_WIDTH != 0) {
+        first = search->cols[depth - 1] / SMALLDOKU_SQUARE_WIDTH * SMALLDOKU_SQUARE_WIDTH;
+        last = first + SMALLDOKU_SQUARE_WIDTH;
+    }
+
+    for (smalldoku_uint8_t source_col = first; source_col < last; source_col++) {
+        if (used & (1U << source_col)) {
+            continue;
+        }
+
+        search->cols[depth] = source_col;
+        search->positions[source_col] = depth;
+
+        smalldoku_uint8_t survivors[PAIR_COUNT];
+        smalldoku_uint8_t survivor_count = 0;
+
+        for (smalldoku_uint8_t i = 0; i < alive_count; i++) {
+            if (pair_may_win(search, search->pairs[alive[i]], depth + 1)) {
+                survivors[survivor_count++] = alive[i];
+            }
+        }
+
+        if (survivor_count != 0) {
+            search_columns(search, depth + 1, used | (1U << source_col), survivors, survivor_count);
+        }
+
+        search->positions[source_col] = UNPLACED;
+    }
+}
+
+/**
+ * Tries all transformations of a solution and puzzle in one orientation.
+ *
+ * @param search the search to continue
+ * @param solution the solution in the orientation to search
+ * @param puzzle the puzzle in the orientation to search
+ */
+static void search_orientation(
+        canonical_search_t *search,
+        const smalldoku_uint8_t *solution,
+        const smalldoku_uint8_t *puzzle
+) {
+    search->solution = solution;
+    search->puzzle = puzzle;
+
+    smalldoku_uint8_t alive[PAIR_COUNT];
+    smalldoku_uint8_t pair = 0;
+
+    for (smalldoku_uint8_t first_row = 0; first_row < SMALLDOKU_GRID_HEIGHT; first_row++) {
+        const smalldoku_uint8_t *first = &solution[first_row * SMALLDOKU_GRID_WIDTH];
+        smalldoku_uint8_t columns[SMALLDOKU_GRID_WIDTH + 1];
+
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            columns[first[col]] = col;
+        }
+
+        smalldoku_uint8_t band = first_row / SMALLDOKU_SQUARE_HEIGHT * SMALLDOKU_SQUARE_HEIGHT;
+
+        for (smalldoku_uint8_t second_row = band; second_row < band + SMALLDOKU_SQUARE_HEIGHT; second_row++) {
+            if (second_row == first_row) {
+                continue;
+            }
+
+            const smalldoku_uint8_t *second = &solution[second_row * SMALLDOKU_GRID_WIDTH];
+
+            for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+                search->pairs[pair][col] = columns[second[col]];
+            }
+
+            alive[pair] = pair;
+            pair++;
+        }
+    }
+
+    smalldoku_memset(search->positions, UNPLACED, SMALLDOKU_GRID_WIDTH);
+
+    search_columns(search, 0, 0, alive, PAIR_COUNT);
+}
+
+smalldoku_uint64_t smalldoku_canonicalize_digits(
+        const smalldoku_uint8_t *puzzle,
+        const smalldoku_uint8_t *solution,
+        smalldoku_uint8_t *canonical_puzzle,
+        smalldoku_uint8_t *canonical_solution
+) {
+    canonical_search_t search;
+    search.labels[0] = 0;
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        search.best_solution[i] = 0xFF;
+    }
+
+    search_orientation(&search, solution, puzzle);
+
+#if ORIENTATION_COUNT == 2
+    smalldoku_uint8_t transposed_solution[SMALLDOKU_CELL_COUNT];
+    smalldoku_uint8_t transposed_puzzle[SMALLDOKU_CELL_COUNT];
+
+    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            transposed_solution[row * SMALLDOKU_GRID_WIDTH + col] = solution[col * SMALLDOKU_GRID_WIDTH + row];
+            transposed_puzzle[row * SMALLDOKU_GRID_WIDTH + col] = puzzle[col * SMALLDOKU_GRID_WIDTH + row];
+        }
+    }
+
+    search_orientation(&search, transposed_solution, transposed_puzzle);
+#endif
+
+    smalldoku_memcpy(canonical_puzzle, search.best_puzzle, SMALLDOKU_CELL_COUNT);
+
+    if (canonical_solution) {
+        smalldoku_memcpy(canonical_solution, search.best_solution, SMALLDOKU_CELL_COUNT);
+    }
+
+    return smalldoku_hash_digits(search.best_puzzle);
+}
+
+smalldoku_uint64_t smalldoku_canonicalize_grid(SMALLDOKU_GRID(grid)) {
+    smalldoku_uint8_t puzzle[SMALLDOKU_CELL_COUNT];
+    smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        puzzle[cell_index] = cell->type == SMALLDOKU_GENERATED_CELL ? cell->value : 0;
+        solution[cell_index] = cell->value;
+    }
+
+    smalldoku_uint64_t hash = smalldoku_canonicalize_digits(puzzle, solution, puzzle, solution);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        cell->type = puzzle[cell_index] != 0 ? SMALLDOKU_GENERATED_CELL : SMALLDOKU_USER_CELL;
+        cell->value = solution[cell_index];
+        cell->user_value = 0;
+    }
+
+    return hash;
+}
+
+smalldoku_uint64_t smalldoku_hash_digits(const smalldoku_uint8_t *digits) {
+    smalldoku_uint64_t hash = 0xcbf29ce484222325UL;
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        hash ^= digits[i];
+        hash *= 0x100000001b3UL;
+    }
+
+    return hash;
+}
@@ -0,0 +1,4 @@
+#include "smalldoku/smalldoku-units.h"
+
+/* The initializer is generated at build time by tools/generate-units.c */
+#include "smalldoku-classic-units.inc"
@@ -0,0 +1,319 @@
+#include "smalldoku/smalldoku-dlx.h"
+#include "smalldoku/smalldoku-memory.h"
+
+#include "smalldoku-search.h"
+#include "smalldoku-stats.h"
+
+#define ROOT_NODE 0
+
+/**
+ * Calculates the first node of the row placing a number into a cell.
+ *
+ * The first node of every row belongs to the cell constraint, the nodes to its right belong to the constraints of
+ * the units of the cell.
+ *
+ * @param dlx the matrix to calculate the node for
+ * @param cell_index the index of the cell in row major order
+ * @param number the number placed into the cell
+ * @return the index of the first node of the row
+ */
+static inline smalldoku_dlx_node_t row_node(
+        const smalldoku_dlx_t *dlx,
+        smalldoku_cell_index_t cell_index,
+        smalldoku_uint8_t number
+) {
+    return 1 + dlx->column_count + dlx->row_stride * (cell_index * SMALLDOKU_GRID_WIDTH + (number - 1));
+}
+
+/**
+ * Calculates the placement (cell index * SMALLDOKU_GRID_WIDTH + number - 1) a row node belongs to.
+ *
+ * @param dlx the matrix the node belongs to
+ * @param node any node of the row
+ * @return the placement of the row
+ */
+static inline smalldoku_dlx_node_t node_placement(const smalldoku_dlx_t *dlx, smalldoku_dlx_node_t node) {
+    return (node - 1 - dlx->column_count) / dlx->row_stride;
+}
+
+/**
+ * Removes a column from the header list and all rows intersecting it from the other columns.
+ *
+ * @param dlx the matrix to operate on
+ * @param c the header node of the column to cover
+ */
+static void cover(smalldoku_dlx_t *dlx, smalldoku_dlx_node_t c) {
+    dlx->left[dlx->right[c]] = dlx->left[c];
+    dlx->right[dlx->left[c]] = dlx->right[c];
+
+    for (smalldoku_dlx_node_t i = dlx->down[c]; i != c; i = dlx->down[i]) {
+        for (smalldoku_dlx_node_t j = dlx->right[i]; j != i; j = dlx->right[j]) {
+            dlx->up[dlx->down[j]] = dlx->up[j];
+            dlx->down[dlx->up[j]] = dlx->down[j];
+            dlx->size[dlx->column[j]]--;
+        }
+    }
+}
+
+/**
+ * Reverts a previous cover of a column.
+ *
+ * @param dlx the matrix to operate on
+ * @param c the header node of the column to uncover
+ */
+static void uncover(smalldoku_dlx_t *dlx, smalldoku_dlx_node_t c) {
+    for (smalldoku_dlx_node_t i = dlx->up[c]; i != c; i = dlx->up[i]) {
+        for (smalldoku_dlx_node_t j = dlx->left[i]; j != i; j = dlx->left[j]) {
+            dlx->size[dlx->column[j]]++;
+            dlx->up[dlx->down[j]] = j;
+            dlx->down[dlx->up[j]] = j;
+        }
+    }
+
+    dlx->left[dlx->right[c]] = c;
+    dlx->right[dlx->left[c]] = c;
+}
+
+/**
+ * Selects a row by covering all columns it intersects and pushes it onto the selection stack.
+ *
+ * @param dlx the matrix to operate on
+ * @param depth the current depth of the selection stack, incremented by one
+ * @param r any node of the row to select
+ */
+static void select_row(smalldoku_dlx_t *dlx, smalldoku_cell_index_t *depth, smalldoku_dlx_node_t r) {
+    smalldoku_dlx_node_t j = r;
+    do {
+        cover(dlx, dlx->column[j]);
+        j = dlx->right[j];
+    } while (j != r);
+
+    smalldoku_uint16_t placement = node_placement(dlx, r);
+    dlx->selected[(*depth)++] = r;
+    dlx->cells[placement / SMALLDOKU_GRID_WIDTH] = placement % SMALLDOKU_GRID_WIDTH + 1;
+}
+
+/**
+ * Pops the topmost row from the selection stack and reverts its selection.
+ *
+ * @param dlx the matrix to operate on
+ * @param depth the current depth of the selection stack, decremented by one
+ * @return the node the row has been selected with
+ */
+static smalldoku_dlx_node_t deselect_row(smalldoku_dlx_t *dlx, smalldoku_cell_index_t *depth) {
+    smalldoku_dlx_node_t r = dlx->selected[--(*depth)];
+
+    smalldoku_dlx_node_t j = r;
+    do {
+        j = dlx->left[j];
+        uncover(dlx, dlx->column[j]);
+    } while (j != r);
+
+    dlx->cells[node_placement(dlx, r) / SMALLDOKU_GRID_WIDTH] = 0;
+    return r;
+}
+
+/**
+ * Finds the column with the fewest remaining rows.
+ *
+ * @param dlx the matrix to search, must contain at least one column
+ * @param stats the statistics to update, or NULL
+ * @return the header node of the column
+ */
+static smalldoku_dlx_node_t choose_column(smalldoku_dlx_t *dlx, smalldoku_stats_t *stats) {
+    smalldoku_dlx_node_t best = dlx->right[ROOT_NODE];
+
+    for (smalldoku_dlx_node_t c = dlx->right[best]; c != ROOT_NODE && dlx->size[best] > 1; c = dlx->right[c]) {
+        STATS_ADD(stats, candidate_checks, 1);
+
+        if (dlx->size[c] < dlx->size[best]) {
+            best = c;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Checks whether the given numbers of a puzzle contradict each other.
+ *
+ * @param units the units of the grid
+ * @param digits the values of the puzzle in row major order
+ * @return 1 if every number appears at most once in every unit, 0 otherwise
+ */
+static int givens_valid(const smalldoku_units_t *units, const smalldoku_uint8_t *digits) {
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        smalldoku_number_mask_t placed = 0;
+
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            smalldoku_uint8_t number = digits[units->cells[unit][i]];
+
+            if (number == 0) {
+                continue;
+            }
+
+            smalldoku_number_mask_t bit = 1 << (number - 1);
+            if (placed & bit) {
+                return 0;
+            }
+
+            placed |= bit;
+        }
+    }
+
+    return 1;
+}
+
+void smalldoku_dlx_init(smalldoku_dlx_t *dlx, const smalldoku_units_t *units) {
+    dlx->units = units;
+    dlx->column_count = SMALLDOKU_CELL_COUNT + units->unit_count * SMALLDOKU_GRID_WIDTH;
+
+    smalldoku_uint8_t max_cell_units = 0;
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        if (units->cell_unit_count[cell_index] > max_cell_units) {
+            max_cell_units = units->cell_unit_count[cell_index];
+        }
+    }
+    dlx->row_stride = 1 + max_cell_units;
+
+    /* Root and column headers form a circular list */
+    for (smalldoku_dlx_node_t c = ROOT_NODE; c <= dlx->column_count; c++) {
+        dlx->left[c] = c == ROOT_NODE ? dlx->column_count : c - 1;
+        dlx->right[c] = c == dlx->column_count ? ROOT_NODE : c + 1;
+        dlx->up[c] = c;
+        dlx->down[c] = c;
+        dlx->column[c] = c;
+        dlx->size[c] = 0;
+    }
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint8_t node_count = 1 + units->cell_unit_count[cell_index];
+
+        for (smalldoku_uint8_t number = 1; number <= SMALLDOKU_GRID_WIDTH; number++) {
+            smalldoku_dlx_node_t first = row_node(dlx, cell_index, number);
+
+            for (smalldoku_uint8_t i = 0; i < node_count; i++) {
+                smalldoku_dlx_node_t node = first + i;
+                smalldoku_dlx_node_t c = i == 0
+                                       ? 1 + cell_index
+                                       : 1 + SMALLDOKU_CELL_COUNT
+                                         + units->cell_units[cell_index][i - 1] * SMALLDOKU_GRID_WIDTH
+                                         + (number - 1);
+
+                dlx->left[node] = i == 0 ? first + node_count - 1 : node - 1;
+                dlx->right[node] = i == node_count - 1 ? first : node + 1;
+
+                dlx->column[node] = c;
+                dlx->up[node] = dlx->up[c];
+                dlx->down[node] = c;
+                dlx->down[dlx->up[c]] = node;
+                dlx->up[c] = node;
+                dlx->size[c]++;
+            }
+        }
+    }
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        dlx->cells[i] = 0;
+    }
+}
+
+smalldoku_uint32_t smalldoku_dlx_solve_digits(
+        smalldoku_dlx_t *dlx,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+) {
+    smalldoku_uint32_t solve_count = 0;
+    smalldoku_uint64_t node_count = 0;
+    STATS_ADD(options->stats, solve_calls, 1);
+
+    if (!givens_valid(dlx->units, digits)) {
+        search_finish(options, SMALLDOKU_SOLVE_COMPLETE, 0);
+        return 0;
+    }
+
+    /* The given numbers are selected up front and form the bottom of the selection stack */
+    smalldoku_cell_index_t depth = 0;
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint8_t number = digits[cell_index];
+
+        if (number != 0) {
+            select_row(dlx, &depth, row_node(dlx, cell_index, number));
+        }
+    }
+
+    smalldoku_cell_index_t given_depth = depth;
+    int backtracking = 0;
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+
+    while (1) {
+        if (!backtracking) {
+            if (dlx->right[ROOT_NODE] == ROOT_NODE) {
+                /* All constraints are satisfied */
+                solve_count++;
+
+                if (solve_count == 1 && options->first_solution) {
+                    smalldoku_memcpy(options->first_solution, dlx->cells, SMALLDOKU_CELL_COUNT);
+                }
+
+                if (options->visitor && !options->visitor(dlx->cells, options->visitor_data)) {
+                    status = SMALLDOKU_SOLVE_STOPPED;
+                    break;
+                }
+
+                if (options->solution_limit != 0 && solve_count >= options->solution_limit) {
+                    status = SMALLDOKU_SOLVE_STOPPED;
+                    break;
+                }
+
+                STATS_ADD(options->stats, backtracks, 1);
+                backtracking = 1;
+                continue;
+            }
+
+            smalldoku_dlx_node_t c = choose_column(dlx, options->stats);
+            if (dlx->size[c] == 0) {
+                STATS_ADD(options->stats, backtracks, 1);
+                backtracking = 1;
+                continue;
+            }
+
+            status = search_check_limits(options, node_count);
+            if (status != SMALLDOKU_SOLVE_COMPLETE) {
+                break;
+            }
+
+            select_row(dlx, &depth, dlx->down[c]);
+            node_count++;
+            STATS_ADD(options->stats, nodes, 1);
+            STATS_MAX(options->stats, max_depth, depth - given_depth);
+            continue;
+        }
+
+        if (depth == given_depth) {
+            break;
+        }
+
+        /* Try the next row of the column the last choice has been made in */
+        smalldoku_dlx_node_t next = dlx->down[deselect_row(dlx, &depth)];
+        if (next != dlx->column[next]) {
+            status = search_check_limits(options, node_count);
+            if (status != SMALLDOKU_SOLVE_COMPLETE) {
+                break;
+            }
+
+            select_row(dlx, &depth, next);
+            node_count++;
+            STATS_ADD(options->stats, nodes, 1);
+            backtracking = 0;
+        }
+    }
+
+    /* Restore the matrix to its initial state for the next solve */
+    while (depth > 0) {
+        deselect_row(dlx, &depth);
+    }
+
+    search_finish(options, status, node_count);
+    return solve_count;
+}
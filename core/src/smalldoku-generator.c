@@ -0,0 +1,286 @@
+#include "smalldoku/smalldoku-generator.h"
+
+#include "smalldoku/smalldoku-memory.h"
+#include "smalldoku/smalldoku-rng.h"
+#include "smalldoku/smalldoku-transform.h"
+
+#include "smalldoku-grid-state.h"
+
+void smalldoku_dig_order(smalldoku_cell_index_t *order, smalldoku_rng_t *rng) {
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        order[i] = i;
+    }
+
+    for (smalldoku_cell_index_t i = SMALLDOKU_CELL_COUNT - 1; i > 0; i--) {
+        smalldoku_cell_index_t j = smalldoku_rng_range(rng, 0, i);
+
+        smalldoku_cell_index_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+/**
+ * Calculates the numbers which don't conflict with any other number in the units of a cell.
+ *
+ * @param units the units of the grid
+ * @param digits the values of the puzzle in row major order
+ * @param cell_index the index of the cell
+ * @return the mask of numbers which could be put into the cell
+ */
+static number_mask_t cell_candidates(
+        const smalldoku_units_t *units,
+        const smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t cell_index
+) {
+    const smalldoku_cell_index_t *peers = units->peers[cell_index];
+
+    number_mask_t used = 0;
+    for (smalldoku_uint8_t i = 0; i < units->peer_count[cell_index]; i++) {
+        if (digits[peers[i]] != 0) {
+            used |= NUMBER_BIT(digits[peers[i]]);
+        }
+    }
+
+    return ALL_NUMBERS_MASK & ~used;
+}
+
+int smalldoku_dig_is_removable(
+        smalldoku_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t cell_index,
+        const smalldoku_dig_options_t *options,
+        smalldoku_uint64_t *node_count,
+        smalldoku_solve_status_t *status
+) {
+    smalldoku_uint8_t number = digits[cell_index];
+
+    if (options->max_technique != SMALLDOKU_TECHNIQUE_NONE) {
+        /* Solving the erased puzzle with the allowed techniques proves it unique, no search needed */
+        if (options->cancel && *options->cancel) {
+            *status = SMALLDOKU_SOLVE_CANCELLED;
+            return 0;
+        }
+
+        if (options->node_budget != 0 && *node_count >= options->node_budget) {
+            *status = SMALLDOKU_SOLVE_BUDGET_EXHAUSTED;
+            return 0;
+        }
+
+        smalldoku_grade_t grade;
+
+        digits[cell_index] = 0;
+        int removable = smalldoku_grade_digits(solver->units, digits, options->max_technique, &grade);
+        digits[cell_index] = number;
+
+        /* A pass of the grader scans every unit, which is about as much work as a search node per number */
+        *node_count += (smalldoku_uint64_t) grade.passes * SMALLDOKU_GRID_WIDTH;
+        return removable;
+    }
+
+    number_mask_t alternatives = cell_candidates(solver->units, digits, cell_index) & ~NUMBER_BIT(number);
+
+    /* Any solution with a different number in the cell is a second solution of the erased puzzle */
+    smalldoku_uint64_t solve_node_count;
+    smalldoku_solve_status_t solve_status;
+    smalldoku_solve_options_t solve_options = {
+            1, 0, 0, 0, &solve_node_count, options->stats, 0, options->cancel, &solve_status
+    };
+
+    int removable = 1;
+    while (alternatives && removable) {
+        number_mask_t bit = alternatives & -alternatives;
+        alternatives ^= bit;
+
+        if (options->node_budget != 0) {
+            if (*node_count >= options->node_budget) {
+                *status = SMALLDOKU_SOLVE_BUDGET_EXHAUSTED;
+                removable = 0;
+                break;
+            }
+
+            solve_options.node_budget = options->node_budget - *node_count;
+        }
+
+        digits[cell_index] = __builtin_ctz(bit) + 1;
+        removable = smalldoku_solver_solve_digits(solver, digits, &solve_options) == 0;
+        *node_count += solve_node_count;
+
+        if (solve_status == SMALLDOKU_SOLVE_BUDGET_EXHAUSTED || solve_status == SMALLDOKU_SOLVE_CANCELLED) {
+            /* Without a finished search there is no telling whether the puzzle stays unique */
+            *status = solve_status;
+            removable = 0;
+        }
+    }
+
+    digits[cell_index] = number;
+    return removable;
+}
+
+smalldoku_cell_index_t smalldoku_dig_digits(
+        smalldoku_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+) {
+    smalldoku_cell_index_t order[SMALLDOKU_CELL_COUNT];
+    smalldoku_dig_order(order, rng);
+
+    smalldoku_cell_index_t clues = 0;
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        clues += digits[i] != 0;
+    }
+
+    smalldoku_uint64_t node_count = 0;
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT && clues > options->target_clues; i++) {
+        smalldoku_cell_index_t cell_index = order[i];
+
+        if (digits[cell_index] != 0 &&
+            smalldoku_dig_is_removable(solver, digits, cell_index, options, &node_count, &status)) {
+            digits[cell_index] = 0;
+            clues--;
+        }
+
+        if (status != SMALLDOKU_SOLVE_COMPLETE) {
+            break;
+        }
+    }
+
+    if (options->node_count) {
+        *options->node_count = node_count;
+    }
+
+    if (options->status) {
+        *options->status = status;
+    }
+
+    return clues;
+}
+
+smalldoku_cell_index_t smalldoku_dig_grid(
+        smalldoku_solver_t *solver,
+        SMALLDOKU_GRID(grid),
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+) {
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+        digits[cell_index] = cell->type == SMALLDOKU_GENERATED_CELL ? cell->value : 0;
+    }
+
+    smalldoku_cell_index_t clues = smalldoku_dig_digits(solver, digits, rng, options);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        if (cell->type == SMALLDOKU_GENERATED_CELL && digits[cell_index] == 0) {
+            cell->type = SMALLDOKU_USER_CELL;
+            cell->user_value = 0;
+        }
+    }
+
+    return clues;
+}
+
+int smalldoku_generator_fill_digits(
+        const smalldoku_units_t *units,
+        smalldoku_uint8_t *solution,
+        smalldoku_rng_t *rng
+) {
+    if (!units || units == &smalldoku_classic_units) {
+        smalldoku_transform_fill_digits(solution, rng);
+        return 1;
+    }
+
+    /* Transformations of the base grids don't preserve the extra units of variants, so those need a search */
+    smalldoku_memset(solution, 0, SMALLDOKU_CELL_COUNT);
+
+    return smalldoku_fill_digits(units, solution, rng);
+}
+
+void smalldoku_generator_start(
+        smalldoku_generator_t *generator,
+        smalldoku_solver_t *solver,
+        smalldoku_cell_index_t target_clues,
+        smalldoku_technique_t max_technique,
+        smalldoku_rng_t *rng
+) {
+    generator->solver = solver;
+    generator->rng = rng;
+    generator->target_clues = target_clues;
+    generator->max_technique = max_technique;
+    generator->phase = SMALLDOKU_GENERATOR_FILL;
+    generator->visited = 0;
+    generator->clues = SMALLDOKU_CELL_COUNT;
+}
+
+int smalldoku_generator_step(smalldoku_generator_t *generator, smalldoku_uint64_t max_work) {
+    if (generator->phase == SMALLDOKU_GENERATOR_FILL) {
+        if (!smalldoku_generator_fill_digits(generator->solver->units, generator->solution, generator->rng)) {
+            /* The regions of the variant don't admit any solution, leave an empty puzzle */
+            smalldoku_memset(generator->puzzle, 0, SMALLDOKU_CELL_COUNT);
+
+            generator->clues = 0;
+            generator->phase = SMALLDOKU_GENERATOR_DONE;
+            return 1;
+        }
+
+        smalldoku_dig_order(generator->order, generator->rng);
+
+        smalldoku_memcpy(generator->puzzle, generator->solution, SMALLDOKU_CELL_COUNT);
+
+        generator->phase = SMALLDOKU_GENERATOR_DIG;
+        return 0;
+    }
+
+    smalldoku_dig_options_t options = {generator->target_clues, 0, 0, 0, 0, 0, generator->max_technique};
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+    smalldoku_uint64_t work = 0;
+
+    while (generator->phase == SMALLDOKU_GENERATOR_DIG && work < max_work) {
+        if (generator->visited == SMALLDOKU_CELL_COUNT || generator->clues <= generator->target_clues) {
+            generator->phase = SMALLDOKU_GENERATOR_DONE;
+            break;
+        }
+
+        smalldoku_cell_index_t cell_index = generator->order[generator->visited++];
+
+        /* Visiting a cell costs at least one unit of work, even if its check needs no search */
+        work++;
+        if (smalldoku_dig_is_removable(generator->solver, generator->puzzle, cell_index, &options, &work, &status)) {
+            generator->puzzle[cell_index] = 0;
+            generator->clues--;
+        }
+    }
+
+    return generator->phase == SMALLDOKU_GENERATOR_DONE;
+}
+
+smalldoku_uint8_t smalldoku_generator_progress(const smalldoku_generator_t *generator) {
+    switch (generator->phase) {
+        case SMALLDOKU_GENERATOR_FILL:
+            return 0;
+
+        case SMALLDOKU_GENERATOR_DIG:
+            return generator->visited * 100 / SMALLDOKU_CELL_COUNT;
+
+        case SMALLDOKU_GENERATOR_DONE:
+            return 100;
+    }
+
+    __asm__("ud2");
+    return 0;
+}
+
+void smalldoku_generator_get_grid(const smalldoku_generator_t *generator, SMALLDOKU_GRID(grid)) {
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        cell->type = generator->puzzle[cell_index] != 0 ? SMALLDOKU_GENERATED_CELL : SMALLDOKU_USER_CELL;
+        cell->value = generator->solution[cell_index];
+        cell->user_value = 0;
+    }
+}
@@ -0,0 +1,555 @@
+#include "smalldoku/smalldoku-grader.h"
+
+#include "smalldoku-grid-state.h"
+
+/**
+ * The cost of a single application of every technique, roughly following the ratings of common human solving
+ * guides.
+ */
+static const smalldoku_uint8_t TECHNIQUE_COSTS[SMALLDOKU_TECHNIQUE_COUNT] = {
+        0,   /* SMALLDOKU_TECHNIQUE_NONE */
+        15,  /* SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE */
+        23,  /* SMALLDOKU_TECHNIQUE_NAKED_SINGLE */
+        28,  /* SMALLDOKU_TECHNIQUE_LOCKED_CANDIDATES */
+        30,  /* SMALLDOKU_TECHNIQUE_NAKED_PAIR */
+        32,  /* SMALLDOKU_TECHNIQUE_X_WING */
+        34,  /* SMALLDOKU_TECHNIQUE_HIDDEN_PAIR */
+        36,  /* SMALLDOKU_TECHNIQUE_NAKED_TRIPLE */
+        38,  /* SMALLDOKU_TECHNIQUE_SWORDFISH */
+        40,  /* SMALLDOKU_TECHNIQUE_HIDDEN_TRIPLE */
+        50,  /* SMALLDOKU_TECHNIQUE_NAKED_QUAD */
+        52,  /* SMALLDOKU_TECHNIQUE_JELLYFISH */
+        54,  /* SMALLDOKU_TECHNIQUE_HIDDEN_QUAD */
+        100, /* SMALLDOKU_TECHNIQUE_GUESSING */
+};
+
+/**
+ * Candidate state of a puzzle being graded.
+ */
+struct grader {
+    /**
+     * The units of the grid.
+     */
+    const smalldoku_units_t *units;
+
+    /**
+     * The current values of all cells in row major order, 0 for empty cells.
+     */
+    smalldoku_uint8_t cells[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The numbers every empty cell can still take, 0 for filled cells.
+     */
+    number_mask_t candidates[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The amount of empty cells.
+     */
+    smalldoku_cell_index_t empty;
+
+    /**
+     * The grade to record the deductions in.
+     */
+    smalldoku_grade_t *grade;
+};
+
+typedef struct grader grader_t;
+
+/**
+ * Records a successful application of a technique.
+ *
+ * @param grader the grader which applied the technique
+ * @param technique the technique applied
+ */
+static inline void record(grader_t *grader, smalldoku_technique_t technique) {
+    grader->grade->counts[technique]++;
+    grader->grade->rating += TECHNIQUE_COSTS[technique];
+
+    if (technique > grader->grade->hardest) {
+        grader->grade->hardest = technique;
+    }
+}
+
+/**
+ * Fills a cell and removes its number from the candidates of all peers.
+ *
+ * @param grader the grader to fill the cell in
+ * @param cell_index the index of the cell to fill
+ * @param number the number to fill the cell with
+ */
+static void place(grader_t *grader, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number) {
+    const smalldoku_units_t *units = grader->units;
+    number_mask_t bit = NUMBER_BIT(number);
+
+    grader->cells[cell_index] = number;
+    grader->candidates[cell_index] = 0;
+    grader->empty--;
+
+    for (smalldoku_uint8_t i = 0; i < units->peer_count[cell_index]; i++) {
+        grader->candidates[units->peers[cell_index][i]] &= ~bit;
+    }
+}
+
+/**
+ * Determines whether a cell belongs to a unit.
+ *
+ * @param units the units of the grid
+ * @param cell_index the index of the cell
+ * @param unit the unit to check
+ * @return 1 if the cell belongs to the unit, 0 otherwise
+ */
+static inline int in_unit(const smalldoku_units_t *units, smalldoku_cell_index_t cell_index, smalldoku_uint8_t unit) {
+    for (smalldoku_uint8_t u = 0; u < units->cell_unit_count[cell_index]; u++) {
+        if (units->cell_units[cell_index][u] == unit) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Calculates the positions within a unit of the cells which can take a number.
+ *
+ * @param grader the grader to look the candidates up in
+ * @param unit the unit to look at
+ * @param bit the number as a mask
+ * @return the mask of positions, bit i standing for the cell units->cells[unit][i]
+ */
+static inline number_mask_t number_positions(const grader_t *grader, smalldoku_uint8_t unit, number_mask_t bit) {
+    const smalldoku_cell_index_t *cells = grader->units->cells[unit];
+    number_mask_t positions = 0;
+
+    for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+        if (grader->candidates[cells[i]] & bit) {
+            positions |= NUMBER_BIT(i + 1);
+        }
+    }
+
+    return positions;
+}
+
+/**
+ * Places every number which only fits into a single cell of a unit.
+ *
+ * @param grader the grader to place the numbers in
+ * @return 1 if a number has been placed, 0 if none was found, -1 if a number doesn't fit anywhere in a unit
+ */
+static int hidden_singles(grader_t *grader) {
+    const smalldoku_units_t *units = grader->units;
+    int found = 0;
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        const smalldoku_cell_index_t *cells = units->cells[unit];
+        number_mask_t placed = 0;
+        number_mask_t once = 0;
+        number_mask_t twice = 0;
+
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            smalldoku_cell_index_t cell_index = cells[i];
+
+            if (grader->cells[cell_index] != 0) {
+                placed |= NUMBER_BIT(grader->cells[cell_index]);
+            } else {
+                twice |= once & grader->candidates[cell_index];
+                once |= grader->candidates[cell_index];
+            }
+        }
+
+        if ((once | placed) != ALL_NUMBERS_MASK) {
+            return -1;
+        }
+
+        number_mask_t singles = once & ~twice;
+        while (singles) {
+            number_mask_t bit = singles & -singles;
+            singles ^= bit;
+
+            /* A single placed before may have taken the cell, which shows up as a contradiction in the next round */
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                if (grader->candidates[cells[i]] & bit) {
+                    place(grader, cells[i], __builtin_ctz(bit) + 1);
+                    record(grader, SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE);
+                    found = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Places the number of every cell which can only take a single number.
+ *
+ * @param grader the grader to place the numbers in
+ * @return 1 if a number has been placed, 0 if none was found, -1 if an empty cell can't take any number
+ */
+static int naked_singles(grader_t *grader) {
+    int found = 0;
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        if (grader->cells[cell_index] != 0) {
+            continue;
+        }
+
+        number_mask_t candidates = grader->candidates[cell_index];
+
+        if (candidates == 0) {
+            return -1;
+        } else if ((candidates & (candidates - 1)) == 0) {
+            place(grader, cell_index, __builtin_ctz(candidates) + 1);
+            record(grader, SMALLDOKU_TECHNIQUE_NAKED_SINGLE);
+            found = 1;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Removes a number from the cells of a unit which share another unit with all cells able to take the number.
+ *
+ * @param grader the grader to remove the candidates in
+ * @return 1 if a candidate has been removed, 0 otherwise
+ */
+static int locked_candidates(grader_t *grader) {
+    const smalldoku_units_t *units = grader->units;
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        const smalldoku_cell_index_t *cells = units->cells[unit];
+
+        for (smalldoku_uint8_t number = 1; number <= SMALLDOKU_GRID_WIDTH; number++) {
+            number_mask_t bit = NUMBER_BIT(number);
+            number_mask_t positions = number_positions(grader, unit, bit);
+
+            if (count_numbers(positions) < 2) {
+                /* Placed numbers and hidden singles are left to the singles */
+                continue;
+            }
+
+            smalldoku_cell_index_t first = cells[__builtin_ctz(positions)];
+
+            for (smalldoku_uint8_t u = 0; u < units->cell_unit_count[first]; u++) {
+                smalldoku_uint8_t other = units->cell_units[first][u];
+                if (other == unit) {
+                    continue;
+                }
+
+                int shared = 1;
+                for (number_mask_t rest = positions; rest && shared; rest &= rest - 1) {
+                    shared = in_unit(units, cells[__builtin_ctz(rest)], other);
+                }
+
+                if (!shared) {
+                    continue;
+                }
+
+                int removed = 0;
+                for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                    smalldoku_cell_index_t cell_index = units->cells[other][i];
+
+                    if ((grader->candidates[cell_index] & bit) && !in_unit(units, cell_index, unit)) {
+                        grader->candidates[cell_index] &= ~bit;
+                        removed = 1;
+                    }
+                }
+
+                if (removed) {
+                    record(grader, SMALLDOKU_TECHNIQUE_LOCKED_CANDIDATES);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Search for a subset: a combination of items whose sets together only cover as many elements as there are items.
+ *
+ * Naked subsets, hidden subsets and fish are all subsets, they differ in what the items and sets are. Once a subset
+ * is found the covered elements can be removed from the sets of all other items, so only subsets where some other
+ * item has a covered element are of interest.
+ */
+struct subset_search {
+    /**
+     * The set of every item, empty sets are never chosen.
+     */
+    number_mask_t sets[SMALLDOKU_GRID_WIDTH];
+
+    /**
+     * The amount of items of the subset to find.
+     */
+    smalldoku_uint8_t size;
+
+    /**
+     * The items of the subset found.
+     */
+    number_mask_t chosen;
+
+    /**
+     * The elements covered by the subset found.
+     */
+    number_mask_t covered;
+};
+
+typedef struct subset_search subset_search_t;
+
+/**
+ * Extends a partial subset by items from a given index on.
+ *
+ * @param search the search to extend the subset of
+ * @param first the index of the first item which may be added
+ * @param chosen the items of the partial subset
+ * @param covered the elements covered by the partial subset
+ * @return 1 if a subset allowing eliminations has been found and written to the search, 0 otherwise
+ */
+static int find_subset(subset_search_t *search, smalldoku_uint8_t first, number_mask_t chosen, number_mask_t covered) {
+    if (count_numbers(chosen) == search->size) {
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            if (!(chosen & NUMBER_BIT(i + 1)) && (search->sets[i] & covered)) {
+                search->chosen = chosen;
+                search->covered = covered;
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    for (smalldoku_uint8_t i = first; i < SMALLDOKU_GRID_WIDTH; i++) {
+        number_mask_t next = covered | search->sets[i];
+
+        if (search->sets[i] != 0 && count_numbers(next) <= search->size &&
+            find_subset(search, i + 1, chosen | NUMBER_BIT(i + 1), next)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Removes the numbers of a naked subset from the other cells of its unit.
+ *
+ * @param grader the grader to remove the candidates in
+ * @param size the amount of cells of the subset
+ * @param technique the technique to record
+ * @return 1 if a candidate has been removed, 0 otherwise
+ */
+static int naked_subsets(grader_t *grader, smalldoku_uint8_t size, smalldoku_technique_t technique) {
+    const smalldoku_units_t *units = grader->units;
+    subset_search_t search;
+    search.size = size;
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        const smalldoku_cell_index_t *cells = units->cells[unit];
+
+        /* Items are the cells of the unit, elements the numbers */
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            search.sets[i] = grader->candidates[cells[i]];
+        }
+
+        if (find_subset(&search, 0, 0, 0)) {
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                if (!(search.chosen & NUMBER_BIT(i + 1))) {
+                    grader->candidates[cells[i]] &= ~search.covered;
+                }
+            }
+
+            record(grader, technique);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Removes the other numbers from the cells of a hidden subset.
+ *
+ * @param grader the grader to remove the candidates in
+ * @param size the amount of numbers of the subset
+ * @param technique the technique to record
+ * @return 1 if a candidate has been removed, 0 otherwise
+ */
+static int hidden_subsets(grader_t *grader, smalldoku_uint8_t size, smalldoku_technique_t technique) {
+    const smalldoku_units_t *units = grader->units;
+    subset_search_t search;
+    search.size = size;
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        const smalldoku_cell_index_t *cells = units->cells[unit];
+
+        /* Items are the numbers, elements the cells of the unit, so the chosen items form a mask of numbers */
+        for (smalldoku_uint8_t n = 0; n < SMALLDOKU_GRID_WIDTH; n++) {
+            search.sets[n] = number_positions(grader, unit, NUMBER_BIT(n + 1));
+        }
+
+        if (find_subset(&search, 0, 0, 0)) {
+            for (number_mask_t rest = search.covered; rest; rest &= rest - 1) {
+                grader->candidates[cells[__builtin_ctz(rest)]] &= search.chosen;
+            }
+
+            record(grader, technique);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Removes a number from the columns (or rows) of a fish: as many rows (or columns) whose cells able to take the
+ * number all lie in as many columns (or rows).
+ *
+ * @param grader the grader to remove the candidates in
+ * @param size the amount of rows of the fish
+ * @param technique the technique to record
+ * @return 1 if a candidate has been removed, 0 otherwise
+ */
+static int fish(grader_t *grader, smalldoku_uint8_t size, smalldoku_technique_t technique) {
+    const smalldoku_units_t *units = grader->units;
+    subset_search_t search;
+    search.size = size;
+
+    /* The rows come first in the units, followed by the columns */
+    for (smalldoku_uint8_t base = 0; base <= SMALLDOKU_GRID_HEIGHT; base += SMALLDOKU_GRID_HEIGHT) {
+        for (smalldoku_uint8_t number = 1; number <= SMALLDOKU_GRID_WIDTH; number++) {
+            number_mask_t bit = NUMBER_BIT(number);
+
+            /* Items are the base lines, elements the crossing lines */
+            for (smalldoku_uint8_t line = 0; line < SMALLDOKU_GRID_WIDTH; line++) {
+                search.sets[line] = number_positions(grader, base + line, bit);
+            }
+
+            if (find_subset(&search, 0, 0, 0)) {
+                for (smalldoku_uint8_t line = 0; line < SMALLDOKU_GRID_WIDTH; line++) {
+                    if (search.chosen & NUMBER_BIT(line + 1)) {
+                        continue;
+                    }
+
+                    for (number_mask_t rest = search.covered; rest; rest &= rest - 1) {
+                        grader->candidates[units->cells[base + line][__builtin_ctz(rest)]] &= ~bit;
+                    }
+                }
+
+                record(grader, technique);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Applies a single technique.
+ *
+ * @param grader the grader to apply the technique in
+ * @param technique the technique to apply
+ * @return 1 if progress has been made, 0 if the technique doesn't apply, -1 if a contradiction has been found
+ */
+static int apply(grader_t *grader, smalldoku_technique_t technique) {
+    switch (technique) {
+        case SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE:
+            return hidden_singles(grader);
+
+        case SMALLDOKU_TECHNIQUE_NAKED_SINGLE:
+            return naked_singles(grader);
+
+        case SMALLDOKU_TECHNIQUE_LOCKED_CANDIDATES:
+            return locked_candidates(grader);
+
+        case SMALLDOKU_TECHNIQUE_NAKED_PAIR:
+            return naked_subsets(grader, 2, technique);
+
+        case SMALLDOKU_TECHNIQUE_X_WING:
+            return fish(grader, 2, technique);
+
+        case SMALLDOKU_TECHNIQUE_HIDDEN_PAIR:
+            return hidden_subsets(grader, 2, technique);
+
+        case SMALLDOKU_TECHNIQUE_NAKED_TRIPLE:
+            return naked_subsets(grader, 3, technique);
+
+        case SMALLDOKU_TECHNIQUE_SWORDFISH:
+            return fish(grader, 3, technique);
+
+        case SMALLDOKU_TECHNIQUE_HIDDEN_TRIPLE:
+            return hidden_subsets(grader, 3, technique);
+
+        case SMALLDOKU_TECHNIQUE_NAKED_QUAD:
+            return naked_subsets(grader, 4, technique);
+
+        case SMALLDOKU_TECHNIQUE_JELLYFISH:
+            return fish(grader, 4, technique);
+
+        case SMALLDOKU_TECHNIQUE_HIDDEN_QUAD:
+            return hidden_subsets(grader, 4, technique);
+
+        default:
+            return 0;
+    }
+}
+
+int smalldoku_grade_digits(
+        const smalldoku_units_t *units,
+        const smalldoku_uint8_t *digits,
+        smalldoku_technique_t max_technique,
+        smalldoku_grade_t *grade
+) {
+    grader_t grader;
+    grader.units = units ? units : &smalldoku_classic_units;
+    grader.empty = SMALLDOKU_CELL_COUNT;
+    grader.grade = grade;
+
+    grade->hardest = SMALLDOKU_TECHNIQUE_NONE;
+    grade->rating = 0;
+    grade->passes = 0;
+    for (smalldoku_uint8_t technique = 0; technique < SMALLDOKU_TECHNIQUE_COUNT; technique++) {
+        grade->counts[technique] = 0;
+    }
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        grader.cells[cell_index] = 0;
+        grader.candidates[cell_index] = ALL_NUMBERS_MASK;
+    }
+
+    int result = 1;
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT && result > 0; cell_index++) {
+        smalldoku_uint8_t number = digits[cell_index];
+
+        if (number != 0) {
+            if (grader.candidates[cell_index] & NUMBER_BIT(number)) {
+                place(&grader, cell_index, number);
+            } else {
+                /* A peer already holds the number */
+                result = -1;
+            }
+        }
+    }
+
+    /* After every step start over with the easiest technique, so every deduction is made the easiest way possible */
+    while (grader.empty > 0 && result > 0) {
+        result = 0;
+
+        for (smalldoku_technique_t technique = SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE;
+             technique <= max_technique && technique < SMALLDOKU_TECHNIQUE_GUESSING && result == 0;
+             technique++) {
+            result = apply(&grader, technique);
+            grade->passes++;
+        }
+    }
+
+    if (grader.empty > 0 || result < 0) {
+        grade->hardest = SMALLDOKU_TECHNIQUE_GUESSING;
+        grade->rating += grader.empty * TECHNIQUE_COSTS[SMALLDOKU_TECHNIQUE_GUESSING];
+        return 0;
+    }
+
+    return 1;
+}
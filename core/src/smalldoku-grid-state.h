@@ -0,0 +1,137 @@
+#pragma once
+
+#include "smalldoku/smalldoku-backtrack.h"
+
+/*
+ * Operations on the occupancy state of a grid, shared by the solver and the generator.
+ */
+
+typedef smalldoku_number_mask_t number_mask_t;
+
+#define ALL_NUMBERS_MASK ((number_mask_t) ((1ul << SMALLDOKU_GRID_WIDTH) - 1))
+#define NUMBER_BIT(number) ((number_mask_t) (1ul << ((number) - 1)))
+
+/**
+ * Counts the numbers contained in a mask.
+ *
+ * @param mask the mask to count the numbers of
+ * @return the number of bits set in the mask
+ */
+static inline smalldoku_uint8_t count_numbers(number_mask_t mask) {
+    smalldoku_uint32_t bits = mask;
+    bits = bits - ((bits >> 1) & 0x55555555);
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+    bits = bits + (bits >> 8);
+    return (bits + (bits >> 16)) & 0x3F;
+}
+
+/**
+ * Initializes a grid state with all cells empty.
+ *
+ * @param state the state to initialize
+ * @param units the units of the grid
+ */
+static inline void state_init(smalldoku_grid_state_t *state, const smalldoku_units_t *units) {
+    state->units = units;
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        state->cells[i] = 0;
+    }
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        state->unit_masks[unit] = 0;
+    }
+
+    state->filled = 0;
+}
+
+/**
+ * Calculates the numbers which can still be placed into a cell.
+ *
+ * Every cell belongs to at least its row, column and region, so those three are combined without a loop and only
+ * the extra units of a variant need one.
+ *
+ * @param state the state to calculate the candidates on
+ * @param cell_index the index of the cell in row major order
+ * @return the mask of numbers which are not yet contained in any unit of the cell
+ */
+static inline number_mask_t state_candidates(const smalldoku_grid_state_t *state, smalldoku_cell_index_t cell_index) {
+    const smalldoku_uint8_t *cell_units = state->units->cell_units[cell_index];
+    number_mask_t used = state->unit_masks[cell_units[0]] |
+                         state->unit_masks[cell_units[1]] |
+                         state->unit_masks[cell_units[2]];
+
+    for (smalldoku_uint8_t u = 3; u < state->units->cell_unit_count[cell_index]; u++) {
+        used |= state->unit_masks[cell_units[u]];
+    }
+
+    return ALL_NUMBERS_MASK & ~used;
+}
+
+/**
+ * Places a number into an empty cell.
+ *
+ * @param state the state to place the number on
+ * @param cell_index the index of the cell in row major order
+ * @param number the number to place, must be a candidate of the cell
+ */
+static inline void state_place(smalldoku_grid_state_t *state, smalldoku_cell_index_t cell_index, smalldoku_uint8_t number) {
+    const smalldoku_uint8_t *cell_units = state->units->cell_units[cell_index];
+    number_mask_t bit = NUMBER_BIT(number);
+
+    state->cells[cell_index] = number;
+    for (smalldoku_uint8_t u = 0; u < state->units->cell_unit_count[cell_index]; u++) {
+        state->unit_masks[cell_units[u]] |= bit;
+    }
+    state->filled++;
+}
+
+/**
+ * Removes the number from a cell previously filled by state_place.
+ *
+ * @param state the state to remove the number from
+ * @param cell_index the index of the cell in row major order
+ */
+static inline void state_remove(smalldoku_grid_state_t *state, smalldoku_cell_index_t cell_index) {
+    const smalldoku_uint8_t *cell_units = state->units->cell_units[cell_index];
+    number_mask_t bit = ~NUMBER_BIT(state->cells[cell_index]);
+
+    state->cells[cell_index] = 0;
+    for (smalldoku_uint8_t u = 0; u < state->units->cell_unit_count[cell_index]; u++) {
+        state->unit_masks[cell_units[u]] &= bit;
+    }
+    state->filled--;
+}
+
+/**
+ * Loads the values of a puzzle into a state.
+ *
+ * @param state the state to load the puzzle into
+ * @param units the units of the grid
+ * @param digits the values of the puzzle in row major order, 0 for empty cells
+ * @return 1 if the values do not contradict each other, 0 otherwise
+ */
+static inline int state_load(
+        smalldoku_grid_state_t *state,
+        const smalldoku_units_t *units,
+        const smalldoku_uint8_t *digits
+) {
+    state_init(state, units);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint8_t number = digits[cell_index];
+
+        if (number == 0) {
+            continue;
+        }
+
+        if (!(state_candidates(state, cell_index) & NUMBER_BIT(number))) {
+            return 0;
+        }
+
+        state_place(state, cell_index, number);
+    }
+
+    return 1;
+}
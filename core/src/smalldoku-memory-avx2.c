@@ -0,0 +1,4 @@
+#define VECTOR_SIZE 32
+#define KERNELS smalldoku_memory_avx2_kernels
+
+#include "smalldoku-memory-kernels.inc"
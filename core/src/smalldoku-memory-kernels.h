@@ -0,0 +1,43 @@
+#pragma once
+
+#include "smalldoku/smalldoku-memory.h"
+
+/**
+ * The implementations of the memory primitives for one instruction set extension, see smalldoku-memory.h.
+ */
+struct memory_kernels {
+    void *(*copy)(void *destination, const void *source, smalldoku_size_t size);
+
+    void *(*set)(void *destination, smalldoku_uint8_t value, smalldoku_size_t size);
+
+    void (*set32)(smalldoku_uint32_t *destination, smalldoku_uint32_t value, smalldoku_size_t count);
+
+    void (*fill_rect32)(
+            smalldoku_uint32_t *destination,
+            smalldoku_size_t pitch,
+            smalldoku_uint32_t width,
+            smalldoku_uint32_t height,
+            smalldoku_uint32_t value
+    );
+
+    void (*copy_rect32)(
+            smalldoku_uint32_t *destination,
+            smalldoku_size_t destination_pitch,
+            const smalldoku_uint32_t *source,
+            smalldoku_size_t source_pitch,
+            smalldoku_uint32_t width,
+            smalldoku_uint32_t height
+    );
+};
+
+typedef struct memory_kernels memory_kernels_t;
+
+/**
+ * The kernels using 16 byte vectors, compiled for SSE2.
+ */
+extern const memory_kernels_t smalldoku_memory_sse2_kernels;
+
+/**
+ * The kernels using 32 byte vectors, compiled for AVX2 and only to be used once CPUID has shown it is available.
+ */
+extern const memory_kernels_t smalldoku_memory_avx2_kernels;
@@ -0,0 +1,4 @@
+#define VECTOR_SIZE 16
+#define KERNELS smalldoku_memory_sse2_kernels
+
+#include "smalldoku-memory-kernels.inc"
@@ -0,0 +1,97 @@
+#include "smalldoku/smalldoku-memory.h"
+
+#include "smalldoku-memory-kernels.h"
+
+/**
+ * The kernels selected by smalldoku_memory_init, SSE2 is part of x86-64 so those are always safe to use.
+ */
+static const memory_kernels_t *kernels = &smalldoku_memory_sse2_kernels;
+
+/**
+ * Queries a leaf of the CPUID instruction.
+ *
+ * @param leaf the leaf to query
+ * @param registers the eax, ebx, ecx and edx values to write the result to
+ */
+static void cpuid(smalldoku_uint32_t leaf, smalldoku_uint32_t registers[4]) {
+    __asm__("cpuid"
+            : "=a"(registers[0]), "=b"(registers[1]), "=c"(registers[2]), "=d"(registers[3])
+            : "a"(leaf), "c"(0));
+}
+
+/**
+ * Checks whether AVX2 instructions may be used.
+ *
+ * Besides the processor supporting them, the system has to have enabled saving the SSE and AVX state (XCR0 bits 1 and
+ * 2), otherwise the instructions fault.
+ *
+ * @return whether AVX2 is usable
+ */
+static int has_avx2(void) {
+    smalldoku_uint32_t registers[4];
+
+    cpuid(0, registers);
+    if (registers[0] < 7) {
+        return 0;
+    }
+
+    cpuid(1, registers);
+    int osxsave = (registers[2] >> 27) & 1;
+    int avx = (registers[2] >> 28) & 1;
+    if (!osxsave || !avx) {
+        return 0;
+    }
+
+    smalldoku_uint32_t xcr0_low;
+    smalldoku_uint32_t xcr0_high;
+    __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    if ((xcr0_low & 0x6) != 0x6) {
+        return 0;
+    }
+
+    cpuid(7, registers);
+    return (registers[1] >> 5) & 1;
+}
+
+smalldoku_memory_isa_t smalldoku_memory_init(void) {
+    if (has_avx2()) {
+        kernels = &smalldoku_memory_avx2_kernels;
+        return SMALLDOKU_MEMORY_AVX2;
+    }
+
+    kernels = &smalldoku_memory_sse2_kernels;
+    return SMALLDOKU_MEMORY_SSE2;
+}
+
+void *smalldoku_memcpy(void *destination, const void *source, smalldoku_size_t size) {
+    return kernels->copy(destination, source, size);
+}
+
+void *smalldoku_memset(void *destination, smalldoku_uint8_t value, smalldoku_size_t size) {
+    return kernels->set(destination, value, size);
+}
+
+void smalldoku_memset32(smalldoku_uint32_t *destination, smalldoku_uint32_t value, smalldoku_size_t count) {
+    kernels->set32(destination, value, count);
+}
+
+void smalldoku_fill_rect32(
+        smalldoku_uint32_t *destination,
+        smalldoku_size_t pitch,
+        smalldoku_uint32_t width,
+        smalldoku_uint32_t height,
+        smalldoku_uint32_t value
+) {
+    kernels->fill_rect32(destination, pitch, width, height, value);
+}
+
+void smalldoku_copy_rect32(
+        smalldoku_uint32_t *destination,
+        smalldoku_size_t destination_pitch,
+        const smalldoku_uint32_t *source,
+        smalldoku_size_t source_pitch,
+        smalldoku_uint32_t width,
+        smalldoku_uint32_t height
+) {
+    kernels->copy_rect32(destination, destination_pitch, source, source_pitch, width, height);
+}
@@ -0,0 +1,87 @@
+#include "smalldoku/smalldoku-rng.h"
+
+/**
+ * Polynomial of the xoshiro256 jump function, advances the state by 2^128 steps.
+ */
+static const smalldoku_uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaUL,
+        0xd5a61266f0c9392cUL,
+        0xa9582618e03fc9aaUL,
+        0x39abdc4529b1661cUL
+};
+
+/**
+ * Rotates the bits of a value to the left.
+ *
+ * @param value the value to rotate
+ * @param amount the amount of bits to rotate by, must be between 1 and 63
+ * @return the rotated value
+ */
+static inline smalldoku_uint64_t rotate_left(smalldoku_uint64_t value, int amount) {
+    return (value << amount) | (value >> (64 - amount));
+}
+
+void smalldoku_rng_seed(smalldoku_rng_t *rng, smalldoku_uint64_t seed) {
+    for (smalldoku_uint8_t i = 0; i < 4; i++) {
+        seed += 0x9e3779b97f4a7c15UL;
+
+        smalldoku_uint64_t mixed = seed;
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9UL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebUL;
+        rng->state[i] = mixed ^ (mixed >> 31);
+    }
+}
+
+smalldoku_uint64_t smalldoku_rng_next(smalldoku_rng_t *rng) {
+    smalldoku_uint64_t *s = rng->state;
+
+    smalldoku_uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    smalldoku_uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+
+    return result;
+}
+
+smalldoku_uint16_t smalldoku_rng_range(smalldoku_rng_t *rng, smalldoku_uint16_t min, smalldoku_uint16_t max) {
+    smalldoku_uint32_t range = (smalldoku_uint32_t) (max - min) + 1;
+
+    /* Lemire's multiply and shift, retrying the few low products which would otherwise be biased */
+    smalldoku_uint64_t product = (smalldoku_rng_next(rng) >> 32) * range;
+    if ((smalldoku_uint32_t) product < range) {
+        smalldoku_uint32_t threshold = -range % range;
+
+        while ((smalldoku_uint32_t) product < threshold) {
+            product = (smalldoku_rng_next(rng) >> 32) * range;
+        }
+    }
+
+    return (smalldoku_uint16_t) (min + (product >> 32));
+}
+
+void smalldoku_rng_split(smalldoku_rng_t *rng, smalldoku_rng_t *out) {
+    *out = *rng;
+
+    smalldoku_uint64_t jumped[4] = {0, 0, 0, 0};
+
+    for (smalldoku_uint8_t word = 0; word < 4; word++) {
+        for (smalldoku_uint8_t bit = 0; bit < 64; bit++) {
+            if (JUMP[word] & (1UL << bit)) {
+                for (smalldoku_uint8_t i = 0; i < 4; i++) {
+                    jumped[i] ^= rng->state[i];
+                }
+            }
+
+            smalldoku_rng_next(rng);
+        }
+    }
+
+    for (smalldoku_uint8_t i = 0; i < 4; i++) {
+        rng->state[i] = jumped[i];
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/*
+ * Handling of the limits and results of smalldoku_solve_options_t shared by all solver backends.
+ */
+
+/**
+ * Checks whether the search may visit another node.
+ *
+ * @param options the options of the running search
+ * @param node_count the number of nodes visited so far
+ * @return SMALLDOKU_SOLVE_COMPLETE if the search may go on, otherwise the reason it has to give up
+ */
+static inline smalldoku_solve_status_t search_check_limits(
+        const smalldoku_solve_options_t *options,
+        smalldoku_uint64_t node_count
+) {
+    if (options->cancel && *options->cancel) {
+        return SMALLDOKU_SOLVE_CANCELLED;
+    }
+
+    if (options->node_budget != 0 && node_count >= options->node_budget) {
+        return SMALLDOKU_SOLVE_BUDGET_EXHAUSTED;
+    }
+
+    return SMALLDOKU_SOLVE_COMPLETE;
+}
+
+/**
+ * Reports the results of a search other than the solutions to the caller.
+ *
+ * @param options the options of the finished search
+ * @param status the reason the search ended
+ * @param node_count the number of nodes visited
+ */
+static inline void search_finish(
+        const smalldoku_solve_options_t *options,
+        smalldoku_solve_status_t status,
+        smalldoku_uint64_t node_count
+) {
+    if (options->node_count) {
+        *options->node_count = node_count;
+    }
+
+    if (options->status) {
+        *options->status = status;
+    }
+}
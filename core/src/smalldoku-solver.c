@@ -0,0 +1,53 @@
+#include "smalldoku/smalldoku-solver.h"
+
+void smalldoku_solver_init(smalldoku_solver_t *solver, const smalldoku_solver_config_t *config) {
+    solver->backend = config->backend;
+    solver->units = config->units ? config->units : &smalldoku_classic_units;
+
+    switch (config->backend) {
+        case SMALLDOKU_SOLVER_BACKTRACK:
+            smalldoku_backtrack_init(&solver->engine.backtrack, solver->units, config->branching, config->propagation);
+            return;
+
+        case SMALLDOKU_SOLVER_DLX:
+            smalldoku_dlx_init(&solver->engine.dlx, solver->units);
+            return;
+
+        case SMALLDOKU_SOLVER_BITBOARD:
+            smalldoku_bitboard_init(&solver->engine.bitboard, solver->units);
+            return;
+    }
+
+    __asm__("ud2");
+}
+
+smalldoku_uint32_t smalldoku_solver_solve_digits(
+        smalldoku_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+) {
+    switch (solver->backend) {
+        case SMALLDOKU_SOLVER_BACKTRACK:
+            return smalldoku_backtrack_solve_digits(&solver->engine.backtrack, digits, options);
+
+        case SMALLDOKU_SOLVER_DLX:
+            return smalldoku_dlx_solve_digits(&solver->engine.dlx, digits, options);
+
+        case SMALLDOKU_SOLVER_BITBOARD:
+            return smalldoku_bitboard_solve_digits(&solver->engine.bitboard, digits, options);
+    }
+
+    __asm__("ud2");
+    return 0;
+}
+
+smalldoku_uint32_t smalldoku_solver_solve_grid(
+        smalldoku_solver_t *solver,
+        SMALLDOKU_GRID(grid),
+        const smalldoku_solve_options_t *options
+) {
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    smalldoku_get_grid_digits(grid, digits);
+
+    return smalldoku_solver_solve_digits(solver, digits, options);
+}
@@ -0,0 +1,117 @@
+#include "smalldoku/smalldoku-split.h"
+
+#include "smalldoku-grid-state.h"
+
+/**
+ * Places the only number left for a cell.
+ *
+ * @param state the state to place the number on
+ * @param digits the values of the puzzle to place the number into as well
+ * @param cell_index the index of the cell in row major order
+ * @param single the mask holding the number to place as its only bit
+ */
+static void place_single(
+        smalldoku_grid_state_t *state,
+        smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t cell_index,
+        number_mask_t single
+) {
+    /* The number below the single bit has as many bits set as the number is less than the bit's number */
+    smalldoku_uint8_t number = count_numbers(single - 1) + 1;
+
+    state_place(state, cell_index, number);
+    digits[cell_index] = number;
+}
+
+smalldoku_split_result_t smalldoku_split_digits(
+        const smalldoku_units_t *units,
+        smalldoku_uint8_t *digits,
+        smalldoku_split_t *split
+) {
+    smalldoku_grid_state_t state;
+    if (!state_load(&state, units ? units : &smalldoku_classic_units, digits)) {
+        return SMALLDOKU_SPLIT_CONTRADICTION;
+    }
+
+    for (;;) {
+        smalldoku_uint8_t placed = 0;
+        smalldoku_uint8_t best_count = SMALLDOKU_GRID_WIDTH + 1;
+
+        for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+            if (state.cells[cell_index] != 0) {
+                continue;
+            }
+
+            number_mask_t candidates = state_candidates(&state, cell_index);
+            smalldoku_uint8_t count = count_numbers(candidates);
+
+            if (count == 0) {
+                return SMALLDOKU_SPLIT_CONTRADICTION;
+            }
+
+            if (count == 1) {
+                place_single(&state, digits, cell_index, candidates);
+                placed = 1;
+            } else if (count < best_count) {
+                best_count = count;
+                split->cell = cell_index;
+                split->candidates = candidates;
+            }
+        }
+
+        if (state.filled == SMALLDOKU_CELL_COUNT) {
+            return SMALLDOKU_SPLIT_SOLVED;
+        }
+
+        if (placed) {
+            continue;
+        }
+
+        /* Hidden singles, only looked for once no naked single is left since they need a pass over every unit */
+        for (smalldoku_uint8_t unit = 0; unit < state.units->unit_count; unit++) {
+            number_mask_t seen_once = 0;
+            number_mask_t seen_twice = 0;
+
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                smalldoku_cell_index_t cell_index = state.units->cells[unit][i];
+                number_mask_t candidates = state.cells[cell_index] ? 0 : state_candidates(&state, cell_index);
+
+                seen_twice |= seen_once & candidates;
+                seen_once |= candidates;
+            }
+
+            if ((seen_once | state.unit_masks[unit]) != ALL_NUMBERS_MASK) {
+                return SMALLDOKU_SPLIT_CONTRADICTION;
+            }
+
+            number_mask_t hidden = seen_once & ~seen_twice;
+            if (hidden == 0) {
+                continue;
+            }
+
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                smalldoku_cell_index_t cell_index = state.units->cells[unit][i];
+                if (state.cells[cell_index] != 0) {
+                    continue;
+                }
+
+                number_mask_t single = state_candidates(&state, cell_index) & hidden;
+                if (single == 0) {
+                    continue;
+                }
+
+                if (count_numbers(single) > 1) {
+                    return SMALLDOKU_SPLIT_CONTRADICTION;
+                }
+
+                place_single(&state, digits, cell_index, single);
+                placed = 1;
+            }
+        }
+
+        if (!placed) {
+            split->empty = SMALLDOKU_CELL_COUNT - state.filled;
+            return SMALLDOKU_SPLIT_BRANCH;
+        }
+    }
+}
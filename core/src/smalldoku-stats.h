@@ -0,0 +1,26 @@
+#pragma once
+
+#include "smalldoku/smalldoku.h"
+
+/*
+ * Updates of smalldoku_stats_t, compiled out entirely unless SMALLDOKU_ENABLE_STATISTICS is defined.
+ */
+
+#ifdef SMALLDOKU_ENABLE_STATISTICS
+#define STATS_ADD(stats, field, amount)                 \
+    do {                                                \
+        if (stats) {                                    \
+            (stats)->field += (amount);                 \
+        }                                               \
+    } while (0)
+
+#define STATS_MAX(stats, field, value)                  \
+    do {                                                \
+        if ((stats) && (stats)->field < (value)) {      \
+            (stats)->field = (value);                   \
+        }                                               \
+    } while (0)
+#else
+#define STATS_ADD(stats, field, amount) do { } while (0)
+#define STATS_MAX(stats, field, value) do { } while (0)
+#endif
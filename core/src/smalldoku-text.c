@@ -0,0 +1,46 @@
+#include "smalldoku/smalldoku-text.h"
+
+int smalldoku_text_parse_digits(const char *text, smalldoku_size_t length, smalldoku_uint8_t *digits) {
+    if (length < SMALLDOKU_TEXT_LENGTH) {
+        return 0;
+    }
+
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        char c = text[i];
+        smalldoku_uint8_t number;
+
+        if (c == '.' || c == '0') {
+            number = 0;
+        } else if (c >= '1' && c <= '9') {
+            number = c - '0';
+        } else if (c >= 'A' && c <= 'Z') {
+            number = c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'z') {
+            number = c - 'a' + 10;
+        } else {
+            return 0;
+        }
+
+        if (number > SMALLDOKU_GRID_WIDTH) {
+            return 0;
+        }
+
+        digits[i] = number;
+    }
+
+    return 1;
+}
+
+void smalldoku_text_format_digits(const smalldoku_uint8_t *digits, char *text) {
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        smalldoku_uint8_t number = digits[i];
+
+        if (number == 0) {
+            text[i] = '.';
+        } else if (number <= 9) {
+            text[i] = (char) ('0' + number);
+        } else {
+            text[i] = (char) ('A' + number - 10);
+        }
+    }
+}
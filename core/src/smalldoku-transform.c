@@ -0,0 +1,136 @@
+#include "smalldoku/smalldoku-transform.h"
+
+#include "smalldoku/smalldoku-rng.h"
+
+#define BAND_COUNT (SMALLDOKU_GRID_HEIGHT / SMALLDOKU_SQUARE_HEIGHT)
+#define STACK_COUNT (SMALLDOKU_GRID_WIDTH / SMALLDOKU_SQUARE_WIDTH)
+
+#if SMALLDOKU_GRID_WIDTH == 9 && SMALLDOKU_GRID_HEIGHT == 9
+/**
+ * Solution grids in row major order the generated grids are derived from.
+ *
+ * The transformations only ever reach grids equivalent to the base grid, so a few unrelated base grids widen the
+ * range of grids which can be produced.
+ */
+static const char *const BASE_GRIDS[] = {
+        "123456789456789123789123456234567891567891234891234567345678912678912345912345678",
+        "943581267681972435275346981367194852129658743854237619536829174412765398798413526",
+        "169753824485612739723948651971365248832497165546821973294586317318274596657139482",
+        "246781395751932846389654712918527463675143928432869571597316284864295137123478659",
+        "594861372387942165612573894741698253956234718823715649165389427439127586278456931",
+        "613489725745326198982715643864932517127854369539671482451293876398167254276548931",
+        "894725613175436829326198754259374186637281945481659372912843567763512498548967231",
+        "238459716516387492947162385695278134723541968481936527859723641364815279172694853"
+};
+
+#define BASE_GRID_COUNT (sizeof(BASE_GRIDS) / sizeof(BASE_GRIDS[0]))
+#endif
+
+/**
+ * Generates a uniformly random permutation of 0 to size - 1.
+ *
+ * @param permutation the array to write the permutation to
+ * @param size the size of the permutation
+ * @param rng the random number generator to use
+ */
+static void permute(smalldoku_uint8_t *permutation, smalldoku_uint8_t size, smalldoku_rng_t *rng) {
+    for (smalldoku_uint8_t i = 0; i < size; i++) {
+        permutation[i] = i;
+    }
+
+    for (smalldoku_uint8_t i = size - 1; i > 0; i--) {
+        smalldoku_uint8_t j = smalldoku_rng_range(rng, 0, i);
+
+        smalldoku_uint8_t tmp = permutation[i];
+        permutation[i] = permutation[j];
+        permutation[j] = tmp;
+    }
+}
+
+/**
+ * Generates a random order of the lines of a grid which keeps the lines of every band (or stack) together.
+ *
+ * @param lines the array to write the line order to
+ * @param group_count the amount of bands or stacks
+ * @param group_size the amount of lines per band or stack
+ * @param rng the random number generator to use
+ */
+static void permute_lines(
+        smalldoku_uint8_t *lines,
+        smalldoku_uint8_t group_count,
+        smalldoku_uint8_t group_size,
+        smalldoku_rng_t *rng
+) {
+    smalldoku_uint8_t groups[SMALLDOKU_GRID_WIDTH];
+    smalldoku_uint8_t within[SMALLDOKU_GRID_WIDTH];
+    permute(groups, group_count, rng);
+
+    for (smalldoku_uint8_t group = 0; group < group_count; group++) {
+        permute(within, group_size, rng);
+
+        for (smalldoku_uint8_t i = 0; i < group_size; i++) {
+            lines[group * group_size + i] = groups[group] * group_size + within[i];
+        }
+    }
+}
+
+/**
+ * Retrieves the value of a cell of the base grid.
+ *
+ * @param base the index of the base grid in the catalog
+ * @param row the row of the cell
+ * @param col the column of the cell
+ * @return the value of the cell
+ */
+static smalldoku_uint8_t base_value(smalldoku_uint8_t base, smalldoku_uint8_t row, smalldoku_uint8_t col) {
+#if SMALLDOKU_GRID_WIDTH == 9 && SMALLDOKU_GRID_HEIGHT == 9
+    return BASE_GRIDS[base][row * SMALLDOKU_GRID_WIDTH + col] - '0';
+#else
+    /* Shifting every row by a square width and every band by one more gives a valid grid of any size */
+    (void) base;
+    return ((row % SMALLDOKU_SQUARE_HEIGHT) * SMALLDOKU_SQUARE_WIDTH + row / SMALLDOKU_SQUARE_HEIGHT + col)
+           % SMALLDOKU_GRID_WIDTH + 1;
+#endif
+}
+
+void smalldoku_transform_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_t *rng) {
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    smalldoku_transform_fill_digits(digits, rng);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH].value = digits[cell_index];
+    }
+}
+
+void smalldoku_transform_fill_digits(smalldoku_uint8_t *digits, smalldoku_rng_t *rng) {
+#if SMALLDOKU_GRID_WIDTH == 9 && SMALLDOKU_GRID_HEIGHT == 9
+    smalldoku_uint8_t base = smalldoku_rng_range(rng, 0, BASE_GRID_COUNT - 1);
+#else
+    smalldoku_uint8_t base = 0;
+#endif
+
+    smalldoku_uint8_t labels[SMALLDOKU_GRID_WIDTH];
+    smalldoku_uint8_t rows[SMALLDOKU_GRID_HEIGHT];
+    smalldoku_uint8_t cols[SMALLDOKU_GRID_WIDTH];
+
+    permute(labels, SMALLDOKU_GRID_WIDTH, rng);
+    permute_lines(rows, BAND_COUNT, SMALLDOKU_SQUARE_HEIGHT, rng);
+    permute_lines(cols, STACK_COUNT, SMALLDOKU_SQUARE_WIDTH, rng);
+
+    /* Transposing swaps bands and stacks, which is only valid if squares are square */
+#if SMALLDOKU_SQUARE_WIDTH == SMALLDOKU_SQUARE_HEIGHT
+    smalldoku_uint8_t transpose = smalldoku_rng_range(rng, 0, 1);
+#else
+    smalldoku_uint8_t transpose = 0;
+#endif
+
+    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            smalldoku_uint8_t value = transpose
+                                      ? base_value(base, cols[col], rows[row])
+                                      : base_value(base, rows[row], cols[col]);
+
+            digits[row * SMALLDOKU_GRID_WIDTH + col] = labels[value - 1] + 1;
+        }
+    }
+}
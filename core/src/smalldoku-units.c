@@ -0,0 +1,140 @@
+#include "smalldoku/smalldoku-units.h"
+
+#define SQUARES_PER_ROW (SMALLDOKU_GRID_WIDTH / SMALLDOKU_SQUARE_WIDTH)
+
+/**
+ * Appends a unit consisting of a rectangle of cells.
+ *
+ * @param units the units to append to
+ * @param row the top row of the rectangle
+ * @param col the left column of the rectangle
+ * @param height the height of the rectangle
+ * @param width the width of the rectangle, height * width must be SMALLDOKU_GRID_WIDTH
+ */
+static void add_rectangle(
+        smalldoku_units_t *units,
+        smalldoku_uint8_t row,
+        smalldoku_uint8_t col,
+        smalldoku_uint8_t height,
+        smalldoku_uint8_t width
+) {
+    smalldoku_cell_index_t *cells = units->cells[units->unit_count++];
+
+    for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+        cells[i] = (row + i / width) * SMALLDOKU_GRID_WIDTH + col + i % width;
+    }
+}
+
+/**
+ * Appends the jigsaw regions as units.
+ *
+ * @param units the units to append to
+ * @param regions the region index of every cell in row major order
+ * @return 1 if every region has exactly SMALLDOKU_GRID_WIDTH cells, 0 otherwise
+ */
+static int add_regions(smalldoku_units_t *units, const smalldoku_uint8_t *regions) {
+    smalldoku_uint8_t sizes[SMALLDOKU_GRID_WIDTH] = {0};
+    smalldoku_uint8_t first = units->unit_count;
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint8_t region = regions[cell_index];
+
+        if (region >= SMALLDOKU_GRID_WIDTH || sizes[region] == SMALLDOKU_GRID_WIDTH) {
+            return 0;
+        }
+
+        units->cells[first + region][sizes[region]++] = cell_index;
+    }
+
+    /* With every region bounded by the grid width, no region can have fewer cells either */
+    units->unit_count += SMALLDOKU_GRID_WIDTH;
+    return 1;
+}
+
+int smalldoku_units_init(smalldoku_units_t *units, smalldoku_uint8_t variants, const smalldoku_uint8_t *regions) {
+    units->unit_count = 0;
+
+    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
+        add_rectangle(units, row, 0, 1, SMALLDOKU_GRID_WIDTH);
+    }
+
+    for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+        add_rectangle(units, 0, col, SMALLDOKU_GRID_HEIGHT, 1);
+    }
+
+    if (variants & SMALLDOKU_VARIANT_JIGSAW) {
+        if (!add_regions(units, regions)) {
+            return 0;
+        }
+    } else {
+        for (smalldoku_uint8_t square = 0; square < SMALLDOKU_GRID_WIDTH; square++) {
+            add_rectangle(
+                    units,
+                    (square / SQUARES_PER_ROW) * SMALLDOKU_SQUARE_HEIGHT,
+                    (square % SQUARES_PER_ROW) * SMALLDOKU_SQUARE_WIDTH,
+                    SMALLDOKU_SQUARE_HEIGHT,
+                    SMALLDOKU_SQUARE_WIDTH
+            );
+        }
+    }
+
+    if (variants & SMALLDOKU_VARIANT_DIAGONAL) {
+        smalldoku_cell_index_t *diagonal = units->cells[units->unit_count++];
+        smalldoku_cell_index_t *anti_diagonal = units->cells[units->unit_count++];
+
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            diagonal[i] = i * SMALLDOKU_GRID_WIDTH + i;
+            anti_diagonal[i] = i * SMALLDOKU_GRID_WIDTH + (SMALLDOKU_GRID_WIDTH - 1 - i);
+        }
+    }
+
+    if (variants & SMALLDOKU_VARIANT_HYPER) {
+        for (smalldoku_uint8_t y = 0; y < SMALLDOKU_HYPER_SQUARES_PER_COLUMN; y++) {
+            for (smalldoku_uint8_t x = 0; x < SMALLDOKU_HYPER_SQUARES_PER_ROW; x++) {
+                add_rectangle(
+                        units,
+                        1 + y * (SMALLDOKU_SQUARE_HEIGHT + 1),
+                        1 + x * (SMALLDOKU_SQUARE_WIDTH + 1),
+                        SMALLDOKU_SQUARE_HEIGHT,
+                        SMALLDOKU_SQUARE_WIDTH
+                );
+            }
+        }
+    }
+
+    /* Units are added rows, columns and regions first, so every cell lists them first as well */
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        units->cell_unit_count[cell_index] = 0;
+    }
+
+    for (smalldoku_uint8_t unit = 0; unit < units->unit_count; unit++) {
+        for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+            smalldoku_cell_index_t cell_index = units->cells[unit][i];
+            units->cell_units[cell_index][units->cell_unit_count[cell_index]++] = unit;
+        }
+    }
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_uint8_t is_peer[SMALLDOKU_CELL_COUNT];
+        for (smalldoku_cell_index_t peer = 0; peer < SMALLDOKU_CELL_COUNT; peer++) {
+            is_peer[peer] = 0;
+        }
+
+        for (smalldoku_uint8_t u = 0; u < units->cell_unit_count[cell_index]; u++) {
+            const smalldoku_cell_index_t *cells = units->cells[units->cell_units[cell_index][u]];
+
+            for (smalldoku_uint8_t i = 0; i < SMALLDOKU_GRID_WIDTH; i++) {
+                is_peer[cells[i]] |= cells[i] != cell_index;
+            }
+        }
+
+        units->peer_count[cell_index] = 0;
+        for (smalldoku_cell_index_t peer = 0; peer < SMALLDOKU_CELL_COUNT; peer++) {
+            if (is_peer[peer]) {
+                units->peers[cell_index][units->peer_count[cell_index]++] = peer;
+            }
+        }
+    }
+
+    return 1;
+}
@@ -1,212 +1,84 @@
 #include "smalldoku/smalldoku.h"
+#include "smalldoku/smalldoku-backtrack.h"
+#include "smalldoku/smalldoku-memory.h"
+#include "smalldoku/smalldoku-rng.h"
+#include "smalldoku/smalldoku-units.h"
 
-/**
- * Checks whether a row already contains a number.
- *
- * @param grid the grid to perform the check on
- * @param row the row to check the number for
- * @param number the number to check for
- * @return 1 if the row already contains the number, 0 otherwise
- */
-static int row_contains(SMALLDOKU_GRID(grid), smalldoku_uint8_t row, smalldoku_uint8_t number) {
-    for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-        if (smalldoku_get_cell_value(grid, row, col) == number) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
+#include "smalldoku-grid-state.h"
 
 /**
- * Checks whether a column already contains a number.
- *
- * @param grid the grid to perform the check on
- * @param row the column to check the number for
- * @param number the number to check for
- * @return 1 if the column already contains the number, 0 otherwise
+ * Branching decision of the generator.
  */
-static int column_contains(SMALLDOKU_GRID(grid), smalldoku_uint8_t col, smalldoku_uint8_t number) {
-    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
-        if (smalldoku_get_cell_value(grid, row, col) == number) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
+struct fill_frame {
+    /**
+     * The numbers which have not been tried yet.
+     */
+    number_mask_t remaining;
+
+    /**
+     * The index of the cell branched on.
+     */
+    smalldoku_cell_index_t cell_index;
+};
 
 /**
- * Checks whether a square already contains a number.
+ * Picks one of the numbers of a mask at random.
  *
- * @param grid the grid to perform the check on
- * @param row the row to find the square for
- * @param col the column to find the square for
- * @param number the number to check for
- * @return 1 if the square already contains the number, 0 otherwise
+ * @param mask the mask to pick from, must not be empty
+ * @param rng the random number generator to use
+ * @return the bit of the picked number
  */
-static int
-square_contains(SMALLDOKU_GRID(grid), smalldoku_uint8_t row, smalldoku_uint8_t col, smalldoku_uint8_t number) {
-    smalldoku_uint8_t square_index = (col / SMALLDOKU_SQUARE_WIDTH) +
-                                     (row / SMALLDOKU_SQUARE_WIDTH) * (SMALLDOKU_GRID_WIDTH / SMALLDOKU_SQUARE_WIDTH);
-    smalldoku_uint8_t square_start_cell =
-            ((square_index % SMALLDOKU_SQUARE_WIDTH) * SMALLDOKU_SQUARE_WIDTH) /* <- row offset */
-            + ((square_index / SMALLDOKU_SQUARE_WIDTH) *
-               (SMALLDOKU_GRID_WIDTH * SMALLDOKU_SQUARE_HEIGHT)); /* column offset */
-
-    for (smalldoku_uint8_t square_y = 0; square_y < SMALLDOKU_SQUARE_HEIGHT; square_y++) {
-        for (smalldoku_uint8_t square_x = 0; square_x < SMALLDOKU_SQUARE_WIDTH; square_x++) {
-            smalldoku_uint8_t current_cell_index = square_start_cell + square_x + (square_y * SMALLDOKU_GRID_WIDTH);
-
-            smalldoku_uint8_t current_row = current_cell_index / SMALLDOKU_GRID_WIDTH;
-            smalldoku_uint8_t current_col = current_cell_index % SMALLDOKU_GRID_HEIGHT;
-
-            if (smalldoku_get_cell_value(grid, current_row, current_col) == number) {
-                return 1;
-            }
-        }
+static number_mask_t pick_number(number_mask_t mask, smalldoku_rng_t *rng) {
+    for (smalldoku_uint8_t skip = smalldoku_rng_range(rng, 0, count_numbers(mask) - 1); skip > 0; skip--) {
+        mask &= mask - 1;
     }
 
-    return 0;
+    return mask & -mask;
 }
 
 /**
- * Determines whether the grid is filled completely.
+ * Fills all empty cells of a state with random numbers.
  *
- * @param grid the grid to check
- * @return 1 if the grid is filled completely, 0 otherwise
- */
-static int grid_filled(SMALLDOKU_GRID(grid)) {
-    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
-        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-            if (smalldoku_get_cell_value(grid, row, col) == 0) {
-                return 0;
-            }
-        }
-    }
-
-    return 1;
-}
-
-/**
- * Shuffles an array using a random function.
+ * Cells are filled in row major order and the numbers of every cell are tried in random order. The search is
+ * iterative, the decision stack holds at most one entry per cell (4 bytes each) and undoing a decision only empties
+ * the cells filled after it.
  *
- * @param array the array to shuffle
- * @param size the size of the array
- * @param rng the random function to use
- */
-static void shuffle(smalldoku_uint8_t *array, smalldoku_uint8_t size, smalldoku_rng_fn rng) {
-    for (smalldoku_uint8_t i = 0; i < size; i++) {
-        smalldoku_uint8_t new_i = rng(0, size - 1);
-
-        if (new_i != i) {
-            smalldoku_uint8_t tmp = array[i];
-            array[i] = array[new_i];
-            array[new_i] = tmp;
-        }
-    }
-}
-
-/**
- * Copies the grid.
- *
- * @param dst the grid to copy to
- * @param src the grid to copy from
- */
-static void copy_grid(SMALLDOKU_GRID(dst), SMALLDOKU_GRID(src)) {
-    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
-        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-            dst[row][col] = src[row][col];
-        }
-    }
-}
-
-/**
- * Recursive function to fill a grid completely.
- *
- * @param grid the grid to fill
- * @param rng the random function to use
+ * @param state the state to fill
+ * @param rng the random number generator to use
  * @return 1 if the grid could be filled, 0 otherwise
  */
-static int fill_grid_internal(SMALLDOKU_GRID(grid), smalldoku_rng_fn rng) {
-    SMALLDOKU_GRID(backup);
-    copy_grid(backup, grid);
-
-    for (smalldoku_uint8_t cell_index = 0;
-         cell_index < SMALLDOKU_GRID_WIDTH * SMALLDOKU_GRID_HEIGHT; cell_index++) {
-        smalldoku_uint8_t row = cell_index / SMALLDOKU_GRID_WIDTH;
-        smalldoku_uint8_t col = cell_index % SMALLDOKU_GRID_HEIGHT;
-
-        if (grid[row][col].value == 0) {
-            smalldoku_uint8_t numbers[SMALLDOKU_GRID_WIDTH];
-            for (smalldoku_uint8_t i = 1; i <= SMALLDOKU_GRID_WIDTH; i++) {
-                numbers[i - 1] = i;
-            }
-            shuffle(numbers, SMALLDOKU_GRID_WIDTH, rng);
-
-            for (smalldoku_uint8_t number_index = 0; number_index < SMALLDOKU_GRID_WIDTH; number_index++) {
-                smalldoku_uint8_t cell_value = numbers[number_index];
-
-                if (
-                        !row_contains(grid, row, cell_value) &&
-                        !column_contains(grid, col, cell_value) &&
-                        !square_contains(grid, row, col, cell_value)
-                        ) {
-                    grid[row][col].value = cell_value;
-
-                    if (grid_filled(grid) || fill_grid_internal(grid, rng)) {
-                        return 1;
-                    }
-                }
-            }
-
-            break;
+static int fill_grid_internal(smalldoku_grid_state_t *state, smalldoku_rng_t *rng) {
+    struct fill_frame frames[SMALLDOKU_CELL_COUNT];
+    smalldoku_cell_index_t depth = 0;
+    smalldoku_cell_index_t cell_index = 0;
+
+    while (state->filled != SMALLDOKU_CELL_COUNT) {
+        while (state->cells[cell_index] != 0) {
+            cell_index++;
         }
-    }
 
-    copy_grid(grid, backup);
-    return 0;
-}
+        struct fill_frame *frame = &frames[depth++];
+        frame->cell_index = cell_index;
+        frame->remaining = state_candidates(state, cell_index);
 
-static int solve_grid_internal(SMALLDOKU_GRID(grid), smalldoku_uint32_t *solve_count, smalldoku_uint8_t start_cell_index) {
-    for (smalldoku_uint8_t cell_index = start_cell_index;
-         cell_index < SMALLDOKU_GRID_WIDTH * SMALLDOKU_GRID_HEIGHT; cell_index++) {
-        smalldoku_uint8_t row = cell_index / SMALLDOKU_GRID_WIDTH;
-        smalldoku_uint8_t col = cell_index % SMALLDOKU_GRID_HEIGHT;
+        /* Only decisions fill cells, so emptying the cell of every abandoned decision restores the state */
+        while (frame->remaining == 0) {
+            if (--depth == 0) {
+                return 0;
+            }
 
-        if (smalldoku_get_cell_value(grid, row, col) != 0) {
-            continue;
+            frame = &frames[depth - 1];
+            state_remove(state, frame->cell_index);
         }
 
-        for (smalldoku_uint8_t i = 1; i <= 9; i++) {
-            if (
-                    !row_contains(grid, row, i) &&
-                    !column_contains(grid, col, i) &&
-                    !square_contains(grid, row, col, i)
-                    ) {
-
-                if (grid[row][col].type == SMALLDOKU_GENERATED_CELL) {
-                    grid[row][col].value = i;
-                } else {
-                    grid[row][col].user_value = i;
-                }
+        number_mask_t bit = pick_number(frame->remaining, rng);
+        frame->remaining ^= bit;
 
-                if (grid_filled(grid)) {
-                    (*solve_count)++;
-                } else {
-                    solve_grid_internal(grid, solve_count, cell_index + 1);
-                }
-
-                if (grid[row][col].type == SMALLDOKU_GENERATED_CELL) {
-                    grid[row][col].value = 0;
-                } else {
-                    grid[row][col].user_value = 0;
-                }
-            }
-        }
+        cell_index = frame->cell_index;
+        state_place(state, cell_index, __builtin_ctz(bit) + 1);
     }
 
-    return 0;
+    return 1;
 }
 
 __attribute__((unused)) static void print_grid(SMALLDOKU_GRID(grid), void(*printf)(const char *fmt, ...)) {
@@ -284,45 +156,127 @@ __attribute__((unused)) static void print_grid(SMALLDOKU_GRID(grid), void(*print
 }
 
 void smalldoku_init(SMALLDOKU_GRID(grid)) {
-    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
-        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
-            smalldoku_cell_t cell = {SMALLDOKU_GENERATED_CELL, 0, 0, 0};
-            grid[row][col] = cell;
+    /* An empty generated cell is all zero bytes, SMALLDOKU_GENERATED_CELL being the first cell type */
+    smalldoku_memset(grid, 0, sizeof(smalldoku_cell_t) * SMALLDOKU_CELL_COUNT);
+}
+
+void smalldoku_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_t *rng) {
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    smalldoku_get_grid_digits(grid, digits);
+
+    if (!smalldoku_fill_digits(0, digits, rng)) {
+        return;
+    }
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH].value = digits[cell_index];
+    }
+}
+
+void smalldoku_hammer_grid(
+        SMALLDOKU_GRID(grid),
+        smalldoku_cell_index_t erase_count,
+        smalldoku_rng_t *rng,
+        smalldoku_stats_t *stats
+) {
+    /* Only generated cells are part of the puzzle, whatever the user entered is not a constraint */
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+        digits[cell_index] = cell->type == SMALLDOKU_GENERATED_CELL ? cell->value : 0;
+    }
+
+    smalldoku_hammer_digits(digits, erase_count, rng, stats);
+
+    for (smalldoku_cell_index_t cell_index = 0; cell_index < SMALLDOKU_CELL_COUNT; cell_index++) {
+        smalldoku_cell_t *cell = &grid[cell_index / SMALLDOKU_GRID_WIDTH][cell_index % SMALLDOKU_GRID_WIDTH];
+
+        if (cell->type == SMALLDOKU_GENERATED_CELL && digits[cell_index] == 0) {
+            cell->type = SMALLDOKU_USER_CELL;
+            cell->user_value = 0;
         }
     }
 }
 
-void smalldoku_fill_grid(SMALLDOKU_GRID(grid), smalldoku_rng_fn rng) {
-    fill_grid_internal(grid, rng);
+int smalldoku_fill_digits(const smalldoku_units_t *units, smalldoku_uint8_t *digits, smalldoku_rng_t *rng) {
+    smalldoku_grid_state_t state;
+    if (!state_load(&state, units ? units : &smalldoku_classic_units, digits)) {
+        return 0;
+    }
+
+    if (state.filled != SMALLDOKU_CELL_COUNT && !fill_grid_internal(&state, rng)) {
+        return 0;
+    }
+
+    smalldoku_memcpy(digits, state.cells, SMALLDOKU_CELL_COUNT);
+    return 1;
 }
 
-void smalldoku_hammer_grid(SMALLDOKU_GRID(grid), smalldoku_uint8_t erase_count, smalldoku_rng_fn rng) {
-    for(smalldoku_uint8_t c = 0; c < erase_count; c++) {
-        while (1) {
-            smalldoku_uint8_t to_erase = rng(0, 80);
+void smalldoku_hammer_digits(
+        smalldoku_uint8_t *digits,
+        smalldoku_cell_index_t erase_count,
+        smalldoku_rng_t *rng,
+        smalldoku_stats_t *stats
+) {
+    smalldoku_backtrack_t backtrack;
+    smalldoku_backtrack_init(
+            &backtrack,
+            &smalldoku_classic_units,
+            SMALLDOKU_BRANCH_MOST_CONSTRAINED,
+            SMALLDOKU_PROPAGATE_SINGLES
+    );
+
+    /* Uniqueness only needs to know whether there is a second solution */
+    smalldoku_solve_options_t options = {2, 0, 0, 0, 0, stats, 0, 0, 0};
+
+    /* Every cell is tried at most once, so this ends even if fewer than erase_count cells can be erased */
+    smalldoku_cell_index_t order[SMALLDOKU_CELL_COUNT];
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        order[i] = i;
+    }
 
-            smalldoku_uint8_t row = to_erase / SMALLDOKU_GRID_WIDTH;
-            smalldoku_uint8_t col = to_erase % SMALLDOKU_GRID_HEIGHT;
+    for (smalldoku_cell_index_t i = SMALLDOKU_CELL_COUNT - 1; i > 0; i--) {
+        smalldoku_cell_index_t j = smalldoku_rng_range(rng, 0, i);
 
-            if(grid[row][col].type == SMALLDOKU_GENERATED_CELL) {
-                grid[row][col].type = SMALLDOKU_USER_CELL;
-                grid[row][col].user_value = 0;
+        smalldoku_cell_index_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
 
-                if(smalldoku_solve_grid(grid) == 1) {
-                    break;
-                } else {
-                    grid[row][col].type = SMALLDOKU_GENERATED_CELL;
-                }
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT && erase_count > 0; i++) {
+        smalldoku_cell_index_t to_erase = order[i];
+        smalldoku_uint8_t number = digits[to_erase];
+
+        if(number != 0) {
+            digits[to_erase] = 0;
+
+            if(smalldoku_backtrack_solve_digits(&backtrack, digits, &options) == 1) {
+                erase_count--;
+            } else {
+                digits[to_erase] = number;
             }
         }
     }
 }
 
 smalldoku_uint32_t smalldoku_solve_grid(SMALLDOKU_GRID(grid)) {
-    smalldoku_uint32_t solve_count = 0;
-    solve_grid_internal(grid, &solve_count, 0);
+    smalldoku_solve_options_t options = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    return smalldoku_solve_grid_bounded(grid, &options);
+}
+
+smalldoku_uint32_t smalldoku_solve_grid_bounded(SMALLDOKU_GRID(grid), const smalldoku_solve_options_t *options) {
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    smalldoku_get_grid_digits(grid, digits);
+
+    smalldoku_backtrack_t backtrack;
+    smalldoku_backtrack_init(
+            &backtrack,
+            &smalldoku_classic_units,
+            SMALLDOKU_BRANCH_MOST_CONSTRAINED,
+            SMALLDOKU_PROPAGATE_SINGLES
+    );
 
-    return solve_count;
+    return smalldoku_backtrack_solve_digits(&backtrack, digits, options);
 }
 
 smalldoku_uint8_t smalldoku_get_cell_value(SMALLDOKU_GRID(grid), smalldoku_uint8_t row, smalldoku_uint8_t col) {
@@ -339,3 +293,11 @@ smalldoku_uint8_t smalldoku_get_cell_value(SMALLDOKU_GRID(grid), smalldoku_uint8
     __asm__("ud2");
     return -1;
 }
+
+void smalldoku_get_grid_digits(SMALLDOKU_GRID(grid), smalldoku_uint8_t *digits) {
+    for (smalldoku_uint8_t row = 0; row < SMALLDOKU_GRID_HEIGHT; row++) {
+        for (smalldoku_uint8_t col = 0; col < SMALLDOKU_GRID_WIDTH; col++) {
+            digits[row * SMALLDOKU_GRID_WIDTH + col] = smalldoku_get_cell_value(grid, row, col);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Build time generator of the classic unit tables.
+ *
+ * Runs on the build host, builds the classic units with smalldoku_units_init and writes them out as the initializer
+ * of smalldoku_classic_units, so the freestanding library gets them as constant data instead of computing them at
+ * runtime.
+ */
+
+#include <stdio.h>
+
+#include "smalldoku/smalldoku-units.h"
+
+/**
+ * Reads a table value, either a byte or a smalldoku_cell_index_t.
+ *
+ * @param values the table to read from
+ * @param size the size of a single value in bytes
+ * @param index the index of the value to read
+ * @return the value
+ */
+static unsigned read_value(const void *values, unsigned size, unsigned index) {
+    if (size == sizeof(smalldoku_cell_index_t)) {
+        return ((const smalldoku_cell_index_t *) values)[index];
+    }
+
+    return ((const smalldoku_uint8_t *) values)[index];
+}
+
+/**
+ * Writes an array of values as a braced initializer.
+ *
+ * @param out the file to write to
+ * @param values the values to write
+ * @param size the size of a single value in bytes
+ * @param count the amount of values
+ */
+static void write_values(FILE *out, const void *values, unsigned size, unsigned count) {
+    fputc('{', out);
+
+    for (unsigned i = 0; i < count; i++) {
+        fprintf(out, i == 0 ? "%u" : ", %u", read_value(values, size, i));
+    }
+
+    fputc('}', out);
+}
+
+/**
+ * Writes a two dimensional array of values as a braced initializer.
+ *
+ * @param out the file to write to
+ * @param values the values to write, row after row
+ * @param size the size of a single value in bytes
+ * @param rows the amount of rows
+ * @param columns the amount of values per row
+ */
+static void write_table(FILE *out, const void *values, unsigned size, unsigned rows, unsigned columns) {
+    fputs("{\n", out);
+
+    for (unsigned row = 0; row < rows; row++) {
+        fputs("                ", out);
+        write_values(out, (const char *) values + row * columns * size, size, columns);
+        fputs(row == rows - 1 ? "\n" : ",\n", out);
+    }
+
+    fputs("        }", out);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output>\n", argv[0]);
+        return 1;
+    }
+
+    static smalldoku_units_t units;
+    smalldoku_units_init(&units, SMALLDOKU_VARIANT_CLASSIC, 0);
+
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/* Generated by tools/generate-units.c for %ux%u grids, do not edit */\n\n",
+            SMALLDOKU_GRID_WIDTH, SMALLDOKU_GRID_HEIGHT);
+    fputs("const smalldoku_units_t smalldoku_classic_units = {\n", out);
+
+    fprintf(out, "        %u,\n        ", units.unit_count);
+    write_table(out, &units.cells[0][0], sizeof(smalldoku_cell_index_t), SMALLDOKU_MAX_UNITS, SMALLDOKU_GRID_WIDTH);
+    fputs(",\n        ", out);
+    write_values(out, units.cell_unit_count, 1, SMALLDOKU_CELL_COUNT);
+    fputs(",\n        ", out);
+    write_table(out, &units.cell_units[0][0], 1, SMALLDOKU_CELL_COUNT, SMALLDOKU_MAX_CELL_UNITS);
+    fputs(",\n        ", out);
+    write_values(out, units.peer_count, 1, SMALLDOKU_CELL_COUNT);
+    fputs(",\n        ", out);
+    write_table(out, &units.peers[0][0], sizeof(smalldoku_cell_index_t), SMALLDOKU_CELL_COUNT, SMALLDOKU_MAX_PEERS);
+    fputs("\n};\n", out);
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
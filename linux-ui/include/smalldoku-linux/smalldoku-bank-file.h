@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <smalldoku/smalldoku-bank.h>
+
+/**
+ * A bank mapped into memory from a file.
+ */
+struct smalldoku_bank_file {
+    /**
+     * The opened bank, pointing directly into the mapping.
+     */
+    smalldoku_bank_t bank;
+
+    /**
+     * The start of the mapping.
+     */
+    void *mapping;
+
+    /**
+     * The size of the mapping in bytes.
+     */
+    size_t size;
+};
+
+typedef struct smalldoku_bank_file smalldoku_bank_file_t;
+
+/**
+ * Maps a bank file read only into memory and opens it.
+ *
+ * Entries are only paged in when they are accessed, so opening even large banks is cheap.
+ *
+ * @param file the bank file to open
+ * @param path the path of the file to map
+ * @return SMALLDOKU_BANK_OK if the bank has been opened, the reason it could not be opened otherwise
+ */
+smalldoku_bank_status_t smalldoku_bank_file_open(smalldoku_bank_file_t *file, const char *path);
+
+/**
+ * Unmaps a bank file opened by smalldoku_bank_file_open.
+ *
+ * @param file the bank file to close
+ */
+void smalldoku_bank_file_close(smalldoku_bank_file_t *file);
+
+/**
+ * Builds a bank from entries and writes it to a file.
+ *
+ * @param path the path of the file to write
+ * @param entries the entries to write
+ * @param entry_count the amount of entries to write
+ * @return SMALLDOKU_BANK_OK if the bank has been written, SMALLDOKU_BANK_IO_ERROR otherwise
+ */
+smalldoku_bank_status_t smalldoku_bank_file_write(
+        const char *path,
+        const smalldoku_bank_entry_t *entries,
+        smalldoku_uint32_t entry_count
+);
+
+/**
+ * Describes a bank status for error messages.
+ *
+ * @param status the status to describe
+ * @return the description of the status
+ */
+const char *smalldoku_bank_status_name(smalldoku_bank_status_t status);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Reads the lines of a file or of the standard input without allocating per line.
+ *
+ * Regular files are mapped into memory and their lines point directly into the mapping. Anything else (pipes,
+ * terminals) is read into a single buffer allocated when opening, the lines point into that buffer and are only valid
+ * until the next line is read.
+ */
+struct smalldoku_line_reader {
+    int fd;
+
+    /**
+     * The mapping of a regular file, or NULL if the file is read into the buffer.
+     */
+    void *mapping;
+    size_t mapping_size;
+
+    /**
+     * The buffer of streamed input, or NULL for mapped files.
+     */
+    char *buffer;
+    size_t capacity;
+
+    /**
+     * The bytes read so far which have not been returned as lines yet.
+     */
+    const char *data;
+    size_t position;
+    size_t size;
+
+    /**
+     * Whether the end of a streamed input has been reached.
+     */
+    int end;
+
+    /**
+     * Whether the rest of a line longer than the buffer is being skipped.
+     */
+    int skipping;
+
+    /**
+     * Whether reading failed, the lines read before are still valid.
+     */
+    int error;
+};
+
+typedef struct smalldoku_line_reader smalldoku_line_reader_t;
+
+/**
+ * Opens a file for reading lines.
+ *
+ * @param reader the reader to initialize
+ * @param path the path of the file to read, or NULL or "-" for the standard input
+ * @return 1 if the file has been opened, 0 otherwise with errno set
+ */
+int smalldoku_line_reader_open(smalldoku_line_reader_t *reader, const char *path);
+
+/**
+ * Closes a reader opened by smalldoku_line_reader_open.
+ *
+ * @param reader the reader to close
+ */
+void smalldoku_line_reader_close(smalldoku_line_reader_t *reader);
+
+/**
+ * Reads the next line.
+ *
+ * Lines longer than the buffer of streamed input are cut at the buffer size, the rest of them is skipped.
+ *
+ * @param reader the reader to read from
+ * @param line the pointer to write the start of the line to, it does not include the line break
+ * @param length the pointer to write the length of the line to
+ * @return 1 if a line has been read, 0 at the end of the input or if reading failed, see error
+ */
+int smalldoku_line_reader_next(smalldoku_line_reader_t *reader, const char **line, size_t *length);
+
+/**
+ * Checks whether reading the next line can block, which is the case if no complete line is buffered and no input is
+ * pending either.
+ *
+ * Callers batching lines can use this to hand off what they have before waiting for a slow producer.
+ *
+ * @param reader the reader to check
+ * @return 1 if smalldoku_line_reader_next may have to wait for input, 0 otherwise
+ */
+int smalldoku_line_reader_would_block(const smalldoku_line_reader_t *reader);
+
+/**
+ * Waits until reading the next line may no longer block, see smalldoku_line_reader_would_block.
+ *
+ * @param reader the reader to wait for
+ * @param timeout_ms the amount of milliseconds to wait at most, 0 to only check
+ * @return 1 if input is available, 0 if the timeout passed
+ */
+int smalldoku_line_reader_wait(const smalldoku_line_reader_t *reader, int timeout_ms);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <smalldoku/smalldoku-generator.h>
+
+#include "smalldoku-linux/smalldoku-parallel-solver.h"
+
+/**
+ * Digs a puzzle like smalldoku_dig_digits, checking many cells at the same time on the threads of a parallel solver.
+ *
+ * The cells are visited in the same order and the result only depends on the random number generator, it is the very
+ * puzzle smalldoku_dig_digits digs. The next cells of the order are checked speculatively in waves of two phases,
+ * every thread taking a cell at a time, see smalldoku_dig_is_removable for why this works:
+ * - A number which can't be erased from the puzzle as it is at the start of the wave can't be erased either way, it
+ *   stays no matter which cells before it are erased. Close to a minimal puzzle this holds for most numbers, just when
+ *   the checks get expensive.
+ * - The other numbers are checked again with all cells of the wave before them erased which don't stay. If the number
+ *   can still be erased, it can be erased no matter which of those cells are erased in the end.
+ * The outcomes are then applied in order, until a cell is reached whose outcome depends on which cells before it have
+ * been erased. The next wave starts at that cell.
+ *
+ * Grader checks (max_technique set) are cheap and not monotonic, so such digs run on the calling thread only. With a
+ * node budget the checks of a wave share the nodes left at its start, so the point the budget runs out at differs from
+ * smalldoku_dig_digits.
+ *
+ * @param solver the initialized parallel solver to check the uniqueness with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, must have a unique solution
+ * @param rng the random number generator to use
+ * @param options the options controlling the dig
+ * @return the amount of numbers left in the puzzle
+ */
+smalldoku_cell_index_t smalldoku_parallel_dig_digits(
+        smalldoku_parallel_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+);
+
+/**
+ * Generates a puzzle on the threads of a parallel solver.
+ *
+ * The solution is filled by smalldoku_generator_fill_digits like smalldoku_generator_t fills it and then dug by
+ * smalldoku_parallel_dig_digits, so the same random number generator state yields the same puzzle as a time sliced
+ * generator.
+ *
+ * @param solver the initialized parallel solver to check the uniqueness with
+ * @param solution buffer of SMALLDOKU_CELL_COUNT values to write the solution to in row major order
+ * @param puzzle buffer of SMALLDOKU_CELL_COUNT values to write the puzzle to in row major order, 0 for erased cells
+ * @param rng the random number generator to use
+ * @param options the options controlling the dig
+ * @return the amount of numbers left in the puzzle, 0 if the units of the solver don't admit any solution
+ */
+smalldoku_cell_index_t smalldoku_parallel_generate_digits(
+        smalldoku_parallel_solver_t *solver,
+        smalldoku_uint8_t *solution,
+        smalldoku_uint8_t *puzzle,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <smalldoku/smalldoku-solver.h>
+
+/**
+ * Solver searching the tree of a single puzzle on multiple threads.
+ *
+ * Every thread walks the top of the search tree itself, branching with smalldoku_split_digits, and hands the
+ * subproblems near the leaves to a solver of its own. Whenever a thread is out of work or fewer subproblems are
+ * waiting than there are threads, the untried branches of the shallowest decision of a working thread are pushed onto
+ * its deque. The owner takes the newest subproblem of its deque first so it keeps working depth first, while threads
+ * out of work steal the oldest (and usually largest) subproblems of the others. No work is ever repeated, so a
+ * single huge subtree can't keep the other threads idle and nothing is wasted on splitting it.
+ */
+struct smalldoku_parallel_solver {
+    /**
+     * The amount of threads searching.
+     */
+    unsigned thread_count;
+
+    /**
+     * The units of the grid the solver has been initialized for.
+     */
+    const smalldoku_units_t *units;
+
+    /**
+     * One solver per thread.
+     */
+    smalldoku_solver_t *solvers;
+};
+
+typedef struct smalldoku_parallel_solver smalldoku_parallel_solver_t;
+
+/**
+ * Initializes a parallel solver, building the solvers of all threads.
+ *
+ * The threads themselves only run during a solve.
+ *
+ * @param solver the parallel solver to initialize
+ * @param config the configuration of the solvers of the threads
+ * @param thread_count the amount of threads to search with, or 0 for one per online processor
+ * @return 1 if the solver has been initialized, 0 if its memory could not be allocated
+ */
+int smalldoku_parallel_solver_init(
+        smalldoku_parallel_solver_t *solver,
+        const smalldoku_solver_config_t *config,
+        unsigned thread_count
+);
+
+/**
+ * Frees the memory of a parallel solver initialized by smalldoku_parallel_solver_init.
+ *
+ * @param solver the parallel solver to destroy
+ */
+void smalldoku_parallel_solver_destroy(smalldoku_parallel_solver_t *solver);
+
+/**
+ * Solves a puzzle on all threads of a parallel solver.
+ *
+ * The options have the same meaning as for smalldoku_solver_solve_digits, with a few differences:
+ * - first_solution receives the solution found first, which is not necessarily the first one in search order.
+ * - The visitor is called with a lock held, so it never runs on two threads at the same time. Solutions are reported
+ *   in no particular order.
+ * - The node count only includes the nodes visited by the solvers, not the branching decisions above them.
+ * - The solution limit, node budget, cancellation and visitor stop all threads. The cancellation flag is polled
+ *   every millisecond by the calling thread, which forwards it to the threads searching.
+ *
+ * @param solver the initialized parallel solver to solve with
+ * @param digits the SMALLDOKU_CELL_COUNT values of the puzzle in row major order, 0 for empty cells
+ * @param options the options controlling the enumeration
+ * @return the number of solutions found before the search ended, at most the solution limit
+ */
+smalldoku_uint32_t smalldoku_parallel_solver_solve_digits(
+        smalldoku_parallel_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+);
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "smalldoku-linux/smalldoku-bank-file.h"
+
+smalldoku_bank_status_t smalldoku_bank_file_open(smalldoku_bank_file_t *file, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return SMALLDOKU_BANK_IO_ERROR;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return SMALLDOKU_BANK_IO_ERROR;
+    }
+
+    if (file_stat.st_size == 0) {
+        close(fd);
+        return SMALLDOKU_BANK_TRUNCATED;
+    }
+
+    void *mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return SMALLDOKU_BANK_IO_ERROR;
+    }
+
+    smalldoku_bank_status_t status = smalldoku_bank_open(&file->bank, mapping, file_stat.st_size);
+    if (status != SMALLDOKU_BANK_OK) {
+        munmap(mapping, file_stat.st_size);
+        return status;
+    }
+
+    /* Lookups jump around the entries, read ahead would only page in unused neighbours */
+    madvise(mapping, file_stat.st_size, MADV_RANDOM);
+
+    file->mapping = mapping;
+    file->size = file_stat.st_size;
+
+    return SMALLDOKU_BANK_OK;
+}
+
+void smalldoku_bank_file_close(smalldoku_bank_file_t *file) {
+    munmap(file->mapping, file->size);
+    file->mapping = NULL;
+    file->size = 0;
+}
+
+smalldoku_bank_status_t smalldoku_bank_file_write(
+        const char *path,
+        const smalldoku_bank_entry_t *entries,
+        smalldoku_uint32_t entry_count
+) {
+    size_t size = smalldoku_bank_size(entry_count);
+
+    /* malloc memory is suitably aligned for the 64 bit members of the bank */
+    void *buffer = malloc(size);
+    if (!buffer) {
+        return SMALLDOKU_BANK_IO_ERROR;
+    }
+
+    smalldoku_bank_build(buffer, entries, entry_count);
+
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        free(buffer);
+        return SMALLDOKU_BANK_IO_ERROR;
+    }
+
+    size_t written = fwrite(buffer, 1, size, out);
+    int close_result = fclose(out);
+    free(buffer);
+
+    return written == size && close_result == 0 ? SMALLDOKU_BANK_OK : SMALLDOKU_BANK_IO_ERROR;
+}
+
+const char *smalldoku_bank_status_name(smalldoku_bank_status_t status) {
+    switch (status) {
+        case SMALLDOKU_BANK_OK:
+            return "ok";
+
+        case SMALLDOKU_BANK_TRUNCATED:
+            return "file is truncated";
+
+        case SMALLDOKU_BANK_BAD_MAGIC:
+            return "not a smalldoku bank";
+
+        case SMALLDOKU_BANK_UNSUPPORTED:
+            return "unsupported bank version or grid size";
+
+        case SMALLDOKU_BANK_BAD_INDEX:
+            return "corrupted clue index";
+
+        case SMALLDOKU_BANK_IO_ERROR:
+            return "I/O error";
+    }
+
+    return "unknown error";
+}
@@ -0,0 +1,572 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <smalldoku/smalldoku-canonical.h>
+#include <smalldoku/smalldoku-generator.h>
+#include <smalldoku/smalldoku-memory.h>
+#include <smalldoku/smalldoku-rng.h>
+#include <smalldoku/smalldoku-text.h>
+
+#include "smalldoku-linux/smalldoku-bank-file.h"
+#include "smalldoku-linux/smalldoku-parallel-generator.h"
+
+/* How often the main thread checks whether the threads are done, and how often it reports the progress with -v */
+#define POLL_INTERVAL_MS 10
+#define PROGRESS_INTERVAL_MS 1000
+
+/* Attempts in a row without a new puzzle after which the requested puzzles are considered out of reach, either because
+ * all distinct puzzles have been found (small grids) or because the clue count or technique can't be met */
+#define MAX_FRUITLESS_ATTEMPTS 10000
+
+/**
+ * The names of the techniques on the command line, indexed by smalldoku_technique_t.
+ */
+static const char *const TECHNIQUE_NAMES[SMALLDOKU_TECHNIQUE_COUNT] = {
+        "none",
+        "hidden-single",
+        "naked-single",
+        "locked-candidates",
+        "naked-pair",
+        "x-wing",
+        "hidden-pair",
+        "naked-triple",
+        "swordfish",
+        "hidden-triple",
+        "naked-quad",
+        "jellyfish",
+        "hidden-quad",
+        "guessing"
+};
+
+/**
+ * What to generate and how, as given on the command line.
+ */
+struct gen_options {
+    /**
+     * The amount of unique puzzles to generate.
+     */
+    smalldoku_uint32_t count;
+
+    /**
+     * The amount of threads generating.
+     */
+    unsigned thread_count;
+
+    /**
+     * Whether all threads dig every single puzzle together instead of each thread digging puzzles of its own.
+     */
+    int parallel;
+
+    smalldoku_uint64_t seed;
+
+    /**
+     * The clue count to dig down to, puzzles which can't be dug that far are dropped. 0 to dig as far as possible.
+     */
+    smalldoku_cell_index_t target_clues;
+
+    /**
+     * The hardest technique the puzzles may need, SMALLDOKU_TECHNIQUE_NONE for any puzzle with a unique solution.
+     */
+    smalldoku_technique_t max_technique;
+
+    /**
+     * The easiest technique the hardest step of the puzzles may need, easier puzzles are dropped.
+     */
+    smalldoku_technique_t min_technique;
+
+    smalldoku_solver_config_t config;
+
+    /**
+     * Whether to write the line format instead of a bank.
+     */
+    int text;
+
+    /**
+     * Whether to report the progress to the standard error while generating.
+     */
+    int verbose;
+
+    const char *path;
+};
+
+typedef struct gen_options gen_options_t;
+
+/**
+ * Set of the canonical hashes of all puzzles generated so far, shared by all threads without locking.
+ *
+ * The set never grows: it is sized for the requested amount of puzzles up front, so it stays at most half full.
+ * Hashes are inserted by claiming an empty slot (0) with a compare and swap, so a hash only ever appears once.
+ */
+struct seen_set {
+    atomic_uint_fast64_t *slots;
+    smalldoku_uint64_t mask;
+};
+
+typedef struct seen_set seen_set_t;
+
+/**
+ * The state shared by all threads of a run.
+ */
+struct gen {
+    const gen_options_t *options;
+
+    seen_set_t seen;
+
+    /**
+     * The generated puzzles in the order they have been found.
+     */
+    smalldoku_bank_entry_t *entries;
+
+    /**
+     * The amount of entries claimed so far, may exceed the requested count once the last puzzles are raced for.
+     */
+    atomic_ulong produced;
+
+    atomic_ulong attempts;
+    atomic_ulong rejected;
+    atomic_ulong duplicates;
+
+    /**
+     * The amount of attempts since the last new puzzle, across all threads.
+     */
+    atomic_ulong fruitless;
+
+    atomic_int stop;
+};
+
+typedef struct gen gen_t;
+
+/**
+ * A generating thread with its own stream of random numbers.
+ */
+struct worker {
+    gen_t *gen;
+    pthread_t thread;
+    smalldoku_rng_t rng;
+    smalldoku_solver_t solver;
+
+    /**
+     * The solver digging each puzzle on all threads, used instead of the solver if not NULL.
+     */
+    smalldoku_parallel_solver_t *parallel;
+};
+
+typedef struct worker worker_t;
+
+/**
+ * Inserts a hash into the set.
+ *
+ * @param set the set to insert into
+ * @param hash the hash to insert
+ * @return 1 if the hash has been inserted, 0 if it already was in the set
+ */
+static int seen_insert(seen_set_t *set, smalldoku_uint64_t hash) {
+    /* 0 marks empty slots, so it shares a slot with 1 */
+    hash |= hash == 0;
+
+    for (smalldoku_uint64_t i = hash & set->mask;; i = (i + 1) & set->mask) {
+        uint_fast64_t expected = 0;
+
+        if (atomic_compare_exchange_strong(&set->slots[i], &expected, hash)) {
+            return 1;
+        }
+
+        if (expected == hash) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * Counts an attempt which yielded no new puzzle, stopping all threads once too many of them came in a row.
+ *
+ * @param gen the run the attempt belongs to
+ */
+static void count_fruitless(gen_t *gen) {
+    if (atomic_fetch_add(&gen->fruitless, 1) + 1 == MAX_FRUITLESS_ATTEMPTS) {
+        atomic_store(&gen->stop, 1);
+    }
+}
+
+static void *run_worker(void *argument) {
+    worker_t *worker = argument;
+    gen_t *gen = worker->gen;
+    const gen_options_t *options = gen->options;
+
+    smalldoku_dig_options_t dig_options = {options->target_clues, 0, NULL, NULL, NULL, NULL, options->max_technique};
+
+    while (!atomic_load(&gen->stop)) {
+        smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+        smalldoku_uint8_t puzzle[SMALLDOKU_CELL_COUNT];
+        smalldoku_uint8_t canonical[SMALLDOKU_CELL_COUNT];
+
+        smalldoku_cell_index_t clues;
+        if (worker->parallel) {
+            clues = smalldoku_parallel_generate_digits(worker->parallel, solution, puzzle, &worker->rng, &dig_options);
+        } else {
+            smalldoku_generator_fill_digits(NULL, solution, &worker->rng);
+            smalldoku_memcpy(puzzle, solution, SMALLDOKU_CELL_COUNT);
+
+            clues = smalldoku_dig_digits(&worker->solver, puzzle, &worker->rng, &dig_options);
+        }
+        atomic_fetch_add(&gen->attempts, 1);
+
+        /* Grade with every technique the grader knows, puzzles it gets stuck on need guessing */
+        smalldoku_grade_t grade;
+        smalldoku_grade_digits(NULL, puzzle, SMALLDOKU_TECHNIQUE_HIDDEN_QUAD, &grade);
+
+        if ((options->target_clues != 0 && clues > options->target_clues) || grade.hardest < options->min_technique) {
+            atomic_fetch_add(&gen->rejected, 1);
+            count_fruitless(gen);
+            continue;
+        }
+
+        if (!seen_insert(&gen->seen, smalldoku_canonicalize_digits(puzzle, solution, canonical, NULL))) {
+            atomic_fetch_add(&gen->duplicates, 1);
+            count_fruitless(gen);
+            continue;
+        }
+
+        atomic_store(&gen->fruitless, 0);
+
+        unsigned long index = atomic_fetch_add(&gen->produced, 1);
+        if (index >= options->count) {
+            break;
+        }
+
+        smalldoku_bank_entry_pack(&gen->entries[index], puzzle, solution, (smalldoku_uint8_t) grade.hardest);
+
+        if (index + 1 == options->count) {
+            atomic_store(&gen->stop, 1);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Writes the puzzles in the line format, one per line.
+ *
+ * @param path the path of the file to write
+ * @param entries the puzzles to write
+ * @param count the amount of puzzles to write
+ * @return 1 if the file has been written, 0 otherwise
+ */
+static int write_text(const char *path, const smalldoku_bank_entry_t *entries, smalldoku_uint32_t count) {
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        return 0;
+    }
+
+    char line[SMALLDOKU_TEXT_LENGTH + 1];
+    line[SMALLDOKU_TEXT_LENGTH] = '\n';
+
+    size_t failed = 0;
+    for (smalldoku_uint32_t i = 0; i < count; i++) {
+        smalldoku_uint8_t puzzle[SMALLDOKU_CELL_COUNT];
+        smalldoku_bank_entry_unpack(&entries[i], puzzle, NULL);
+        smalldoku_text_format_digits(puzzle, line);
+
+        failed |= fwrite(line, 1, sizeof(line), out) != sizeof(line);
+    }
+
+    int close_result = out == stdout ? fflush(out) : fclose(out);
+    return !failed && close_result == 0;
+}
+
+/**
+ * Looks up a technique by its name.
+ *
+ * @param name the name to look up
+ * @param technique the technique to write to
+ * @return 1 if the technique has been found, 0 otherwise
+ */
+static int parse_technique(const char *name, smalldoku_technique_t *technique) {
+    for (int i = 0; i < SMALLDOKU_TECHNIQUE_COUNT; i++) {
+        if (strcmp(name, TECHNIQUE_NAMES[i]) == 0) {
+            *technique = (smalldoku_technique_t) i;
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "Unknown technique %s\n", name);
+    return 0;
+}
+
+static void print_usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-n count] [-j threads] [-p] [-s seed] [-c clues] [-d technique] [-m technique]\n"
+            "          [-b backtrack|dlx|bitboard] [-t] [-v] output\n"
+            "Generates unique puzzles, none equivalent to another, and writes them to a puzzle bank (or - with -t).\n"
+            "  -n  the amount of puzzles to generate (default 1000)\n"
+            "  -j  the amount of threads to generate on, 0 for one per processor (default 0)\n"
+            "  -p  dig every puzzle on all threads together, for large grids where a single puzzle takes long\n"
+            "  -s  the seed of the random numbers, every thread gets its own stream of it (default the time)\n"
+            "  -c  the clue count to dig down to, puzzles which can't be dug that far are dropped (default minimal)\n"
+            "  -d  the hardest technique the puzzles may need (default any puzzle with a unique solution)\n"
+            "  -m  the easiest technique the hardest step of the puzzles may need (default none)\n"
+            "  -b  the solver backend to check uniqueness with (default bitboard)\n"
+            "  -t  write one puzzle per line in the %d character line format instead of a bank\n"
+            "  -v  report the progress to the standard error while generating\n"
+            "Stops early, writing the puzzles found so far, once %d attempts in a row yield no new puzzle.\n"
+            "Techniques from easiest to hardest:",
+            name, SMALLDOKU_TEXT_LENGTH, MAX_FRUITLESS_ATTEMPTS);
+
+    for (int i = SMALLDOKU_TECHNIQUE_HIDDEN_SINGLE; i < SMALLDOKU_TECHNIQUE_COUNT; i++) {
+        fprintf(stderr, " %s", TECHNIQUE_NAMES[i]);
+    }
+
+    fprintf(stderr, "\n");
+}
+
+/**
+ * Reads the command line.
+ *
+ * @param argc the amount of arguments
+ * @param argv the arguments
+ * @param options the options to fill
+ * @return 1 if the command line is valid, 0 otherwise
+ */
+static int parse_arguments(int argc, char **argv, gen_options_t *options) {
+    options->count = 1000;
+    options->thread_count = 0;
+    options->parallel = 0;
+    options->seed = (smalldoku_uint64_t) time(NULL);
+    options->target_clues = 0;
+    options->max_technique = SMALLDOKU_TECHNIQUE_NONE;
+    options->min_technique = SMALLDOKU_TECHNIQUE_NONE;
+    options->config.backend = SMALLDOKU_SOLVER_BITBOARD;
+    options->config.branching = SMALLDOKU_BRANCH_MOST_CONSTRAINED;
+    options->config.propagation = SMALLDOKU_PROPAGATE_SINGLES;
+    options->config.units = NULL;
+    options->text = 0;
+    options->verbose = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:j:ps:c:d:m:b:tvh")) != -1) {
+        switch (option) {
+            case 'n':
+                options->count = (smalldoku_uint32_t) strtoul(optarg, NULL, 0);
+                break;
+
+            case 'j':
+                options->thread_count = (unsigned) strtoul(optarg, NULL, 0);
+                break;
+
+            case 'p':
+                options->parallel = 1;
+                break;
+
+            case 's':
+                options->seed = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'c':
+                options->target_clues = (smalldoku_cell_index_t) strtoul(optarg, NULL, 0);
+                break;
+
+            case 'd':
+                if (!parse_technique(optarg, &options->max_technique)) {
+                    return 0;
+                }
+
+                /* Allowing guesses is the same as not asking the grader at all */
+                if (options->max_technique == SMALLDOKU_TECHNIQUE_GUESSING) {
+                    options->max_technique = SMALLDOKU_TECHNIQUE_NONE;
+                }
+                break;
+
+            case 'm':
+                if (!parse_technique(optarg, &options->min_technique)) {
+                    return 0;
+                }
+                break;
+
+            case 'b':
+                if (strcmp(optarg, "backtrack") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_BACKTRACK;
+                } else if (strcmp(optarg, "dlx") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_DLX;
+                } else if (strcmp(optarg, "bitboard") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_BITBOARD;
+                } else {
+                    fprintf(stderr, "Unknown solver backend %s\n", optarg);
+                    return 0;
+                }
+                break;
+
+            case 't':
+                options->text = 1;
+                break;
+
+            case 'v':
+                options->verbose = 1;
+                break;
+
+            default:
+                return 0;
+        }
+    }
+
+    if (optind != argc - 1 || options->count == 0) {
+        return 0;
+    }
+
+    if (options->max_technique != SMALLDOKU_TECHNIQUE_NONE && options->min_technique > options->max_technique) {
+        fprintf(stderr, "The easiest technique is harder than the hardest one\n");
+        return 0;
+    }
+
+    if (options->thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        options->thread_count = online > 0 ? (unsigned) online : 1;
+    }
+
+    options->path = argv[optind];
+    return 1;
+}
+
+static double seconds_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    smalldoku_memory_init();
+
+    gen_options_t options;
+    if (!parse_arguments(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    /* At most one puzzle per thread is inserted beyond the requested count, twice that keeps the set half empty */
+    smalldoku_uint64_t capacity = 1024;
+    while (capacity < 2 * ((smalldoku_uint64_t) options.count + options.thread_count)) {
+        capacity *= 2;
+    }
+
+    gen_t gen;
+    gen.options = &options;
+    gen.seen.slots = calloc(capacity, sizeof(atomic_uint_fast64_t));
+    gen.seen.mask = capacity - 1;
+    gen.entries = malloc((size_t) options.count * sizeof(smalldoku_bank_entry_t));
+    atomic_init(&gen.produced, 0);
+    atomic_init(&gen.attempts, 0);
+    atomic_init(&gen.rejected, 0);
+    atomic_init(&gen.duplicates, 0);
+    atomic_init(&gen.fruitless, 0);
+    atomic_init(&gen.stop, 0);
+
+    /* If the threads dig every puzzle together, they all work for a single worker */
+    unsigned worker_count = options.parallel ? 1 : options.thread_count;
+
+    worker_t *workers = malloc(worker_count * sizeof(worker_t));
+    if (!gen.seen.slots || !gen.entries || !workers) {
+        fprintf(stderr, "Out of memory!\n");
+        return 1;
+    }
+
+    smalldoku_parallel_solver_t parallel;
+    if (options.parallel && !smalldoku_parallel_solver_init(&parallel, &options.config, options.thread_count)) {
+        fprintf(stderr, "Out of memory!\n");
+        return 1;
+    }
+
+    fprintf(stderr, "Using seed %lu\n", (unsigned long) options.seed);
+
+    /* Every thread continues on its own stream split off the seeded one, so no two threads dig alike */
+    smalldoku_rng_t rng;
+    smalldoku_rng_seed(&rng, options.seed);
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    unsigned started = 0;
+    for (; started < worker_count; started++) {
+        worker_t *worker = &workers[started];
+        worker->gen = &gen;
+        worker->parallel = options.parallel ? &parallel : NULL;
+        smalldoku_rng_split(&rng, &worker->rng);
+        smalldoku_solver_init(&worker->solver, &options.config);
+
+        if (pthread_create(&worker->thread, NULL, run_worker, worker) != 0) {
+            break;
+        }
+    }
+
+    if (started == 0) {
+        fprintf(stderr, "Failed to start any thread!\n");
+        return 1;
+    }
+
+    for (unsigned polls = 1; !atomic_load(&gen.stop); polls++) {
+        struct timespec interval = {0, POLL_INTERVAL_MS * 1000000L};
+        nanosleep(&interval, NULL);
+
+        if (options.verbose && polls % (PROGRESS_INTERVAL_MS / POLL_INTERVAL_MS) == 0) {
+            unsigned long produced = atomic_load(&gen.produced);
+            double seconds = seconds_since(&start_time);
+
+            fprintf(stderr, "%lu/%lu puzzles, %.0f puzzles/s, %lu rejected, %lu duplicates\n",
+                    produced < options.count ? produced : (unsigned long) options.count,
+                    (unsigned long) options.count, (double) produced / seconds,
+                    (unsigned long) atomic_load(&gen.rejected), (unsigned long) atomic_load(&gen.duplicates));
+        }
+    }
+
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    /* Threads may have raced past the requested count, or given up before reaching it */
+    unsigned long produced = atomic_load(&gen.produced);
+    smalldoku_uint32_t count = produced < options.count ? (smalldoku_uint32_t) produced : options.count;
+
+    double seconds = seconds_since(&start_time);
+    fprintf(stderr, "Generated %lu puzzles on %u threads in %.3fs, %.0f puzzles/s (%lu dug, %lu rejected, "
+                    "%lu duplicates)\n",
+            (unsigned long) count, options.parallel ? options.thread_count : started, seconds,
+            (double) count / seconds,
+            (unsigned long) atomic_load(&gen.attempts), (unsigned long) atomic_load(&gen.rejected),
+            (unsigned long) atomic_load(&gen.duplicates));
+
+    int status = 0;
+    if (count < options.count) {
+        fprintf(stderr, "Gave up after %d attempts in a row without a new puzzle, found %lu of %lu puzzles\n",
+                MAX_FRUITLESS_ATTEMPTS, (unsigned long) count, (unsigned long) options.count);
+        status = 1;
+    }
+
+    if (options.text) {
+        if (!write_text(options.path, gen.entries, count)) {
+            fprintf(stderr, "Failed to write %s\n", options.path);
+            status = 1;
+        }
+    } else {
+        smalldoku_bank_status_t bank_status = smalldoku_bank_file_write(options.path, gen.entries, count);
+
+        if (bank_status != SMALLDOKU_BANK_OK) {
+            fprintf(stderr, "Failed to write %s: %s\n", options.path, smalldoku_bank_status_name(bank_status));
+            status = 1;
+        }
+    }
+
+    if (options.parallel) {
+        smalldoku_parallel_solver_destroy(&parallel);
+    }
+
+    free(workers);
+    free(gen.entries);
+    free(gen.seen.slots);
+
+    return status;
+}
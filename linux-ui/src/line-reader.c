@@ -0,0 +1,188 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "smalldoku-linux/smalldoku-line-reader.h"
+
+/* Holds many thousand lines of the common puzzle format, so a single read fills whole batches */
+#define STREAM_BUFFER_SIZE (1 << 20)
+
+int smalldoku_line_reader_open(smalldoku_line_reader_t *reader, const char *path) {
+    int fd = path && strcmp(path, "-") != 0 ? open(path, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0) {
+        return 0;
+    }
+
+    reader->fd = fd;
+    reader->mapping = NULL;
+    reader->mapping_size = 0;
+    reader->buffer = NULL;
+    reader->capacity = 0;
+    reader->data = NULL;
+    reader->position = 0;
+    reader->size = 0;
+    reader->end = 0;
+    reader->skipping = 0;
+    reader->error = 0;
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+        if (file_stat.st_size == 0) {
+            reader->end = 1;
+            return 1;
+        }
+
+        void *mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            /* The lines are read once front to back, read ahead pays off */
+            madvise(mapping, file_stat.st_size, MADV_SEQUENTIAL);
+
+            reader->mapping = mapping;
+            reader->mapping_size = file_stat.st_size;
+            reader->data = mapping;
+            reader->size = file_stat.st_size;
+            reader->end = 1;
+            return 1;
+        }
+    }
+
+    reader->buffer = malloc(STREAM_BUFFER_SIZE);
+    if (!reader->buffer) {
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+
+        errno = ENOMEM;
+        return 0;
+    }
+
+    reader->capacity = STREAM_BUFFER_SIZE;
+    reader->data = reader->buffer;
+    return 1;
+}
+
+void smalldoku_line_reader_close(smalldoku_line_reader_t *reader) {
+    if (reader->mapping) {
+        munmap(reader->mapping, reader->mapping_size);
+    }
+
+    free(reader->buffer);
+
+    if (reader->fd != STDIN_FILENO) {
+        close(reader->fd);
+    }
+
+    reader->mapping = NULL;
+    reader->buffer = NULL;
+    reader->data = NULL;
+}
+
+/**
+ * Reads more streamed input, moving the unread bytes to the start of the buffer first.
+ *
+ * @param reader the reader to fill, sets end once nothing more can be read
+ */
+static void fill_buffer(smalldoku_line_reader_t *reader) {
+    size_t unread = reader->size - reader->position;
+    memmove(reader->buffer, reader->buffer + reader->position, unread);
+    reader->position = 0;
+    reader->size = unread;
+
+    for (;;) {
+        ssize_t result = read(reader->fd, reader->buffer + reader->size, reader->capacity - reader->size);
+
+        if (result > 0) {
+            reader->size += result;
+            return;
+        }
+
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+
+        reader->error = result < 0;
+        reader->end = 1;
+        return;
+    }
+}
+
+int smalldoku_line_reader_next(smalldoku_line_reader_t *reader, const char **line, size_t *length) {
+    for (;;) {
+        const char *start = reader->data + reader->position;
+        size_t available = reader->size - reader->position;
+        const char *newline = available ? memchr(start, '\n', available) : NULL;
+
+        if (newline) {
+            reader->position += newline - start + 1;
+
+            if (reader->skipping) {
+                reader->skipping = 0;
+                continue;
+            }
+
+            *line = start;
+            *length = newline - start;
+            return 1;
+        }
+
+        if (!reader->end) {
+            if (available == reader->capacity) {
+                /* The buffer is full of a single line, return what fits and drop the rest of it */
+                reader->position = reader->size;
+
+                if (!reader->skipping) {
+                    reader->skipping = 1;
+                    *line = start;
+                    *length = available;
+                    return 1;
+                }
+            } else {
+                fill_buffer(reader);
+            }
+
+            continue;
+        }
+
+        reader->position = reader->size;
+
+        if (available == 0 || reader->skipping) {
+            reader->skipping = 0;
+            return 0;
+        }
+
+        /* The last line lacks a line break */
+        *line = start;
+        *length = available;
+        return 1;
+    }
+}
+
+int smalldoku_line_reader_would_block(const smalldoku_line_reader_t *reader) {
+    return !smalldoku_line_reader_wait(reader, 0);
+}
+
+int smalldoku_line_reader_wait(const smalldoku_line_reader_t *reader, int timeout_ms) {
+    if (reader->end) {
+        return 1;
+    }
+
+    size_t available = reader->size - reader->position;
+    if (available != 0 && memchr(reader->data + reader->position, '\n', available) != NULL) {
+        return 1;
+    }
+
+    /* Pipes deliver input in chunks which rarely end at a line break, only an empty pipe means the producer stalls */
+    struct pollfd descriptor = {reader->fd, POLLIN, 0};
+    int result;
+    do {
+        result = poll(&descriptor, 1, timeout_ms);
+    } while (result < 0 && errno == EINTR);
+
+    /* Errors and hangups are reported by the next read without waiting */
+    return result != 0;
+}
@@ -1,7 +1,10 @@
 #include <stdlib.h>
 
+#include <smalldoku/smalldoku-memory.h>
+
 #include "smalldoku-linux/smalldoku-x11.h"
 
 int main(int argc, const char **argv) {
+    smalldoku_memory_init();
     return smalldoku_run_x11(argc, argv);
 }
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "smalldoku-linux/smalldoku-parallel-generator.h"
+
+/* The amount of cells checked per wave and thread, more than one so no thread idles on a cheap check */
+#define CELLS_PER_THREAD 2
+
+/*
+ * The search nodes a check with the earlier cells erased may use, relative to the check against the puzzle of the
+ * wave. Erasing many cells at once can make the check far more expensive than any check of the sequential dig, such
+ * checks are given up and their cells left undecided instead.
+ */
+#define SPECULATION_FACTOR 4
+#define SPECULATION_MIN_NODES 256
+
+/**
+ * What the checks of a wave found out about a cell.
+ */
+enum check_outcome {
+    /**
+     * The number can be erased, whichever cells before it are erased.
+     */
+    CHECK_REMOVABLE,
+
+    /**
+     * The number has to stay, whichever cells before it are erased.
+     */
+    CHECK_KEPT,
+
+    /**
+     * The number can be erased if none of the cells before it are erased, but not if all of them which may be erased
+     * are.
+     */
+    CHECK_UNDECIDED
+};
+
+typedef enum check_outcome check_outcome_t;
+
+/**
+ * The check of a single cell in a wave.
+ */
+struct check {
+    smalldoku_cell_index_t cell;
+
+    /**
+     * The index of the cell in the visiting order.
+     */
+    smalldoku_cell_index_t position;
+
+    /**
+     * The outcome of the first phase.
+     */
+    check_outcome_t outcome;
+
+    /**
+     * Whether an undecided number turned out to be removable in the second phase, the outcome is only written by the
+     * first phase since the second phase reads the outcomes of other cells.
+     */
+    int confirmed;
+
+    /**
+     * Whether the check of the second phase ran out of search nodes, so its outcome tells nothing.
+     */
+    int given_up;
+
+    /**
+     * The search nodes used by the check of the first phase.
+     */
+    smalldoku_uint64_t nodes;
+
+    /**
+     * SMALLDOKU_SOLVE_COMPLETE if the checks could be finished, the reason they could not otherwise.
+     */
+    smalldoku_solve_status_t status;
+};
+
+typedef struct check check_t;
+
+/**
+ * The state shared by all threads of a single dig.
+ */
+struct dig {
+    smalldoku_parallel_solver_t *solver;
+    const smalldoku_dig_options_t *options;
+
+    /**
+     * The puzzle as it is at the start of the current wave.
+     */
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The cells checked in the current wave, in the order they are visited.
+     */
+    check_t checks[SMALLDOKU_CELL_COUNT];
+    unsigned check_count;
+
+    /**
+     * The index of the next check to take.
+     */
+    atomic_uint next_check;
+
+    /**
+     * Whether the waves checks against the puzzle of the wave (0) or with the earlier cells erased (1).
+     */
+    int phase;
+
+    /**
+     * The search nodes used by all checks so far.
+     */
+    atomic_uint_fast64_t nodes;
+
+    /**
+     * The statistics of every thread, merged once the dig is done.
+     */
+    smalldoku_stats_t *stats;
+
+    /**
+     * Incremented to start a wave, threads go home once done is set.
+     */
+    pthread_mutex_t lock;
+    pthread_cond_t wave_started;
+    pthread_cond_t wave_finished;
+    unsigned wave;
+    int done;
+
+    /**
+     * The amount of started threads which are done with the current wave, the next wave only starts once all are.
+     */
+    unsigned finished_workers;
+};
+
+typedef struct dig dig_t;
+
+/**
+ * The state of a single thread of a dig.
+ */
+struct dig_worker {
+    dig_t *dig;
+    unsigned index;
+    pthread_t thread;
+};
+
+typedef struct dig_worker dig_worker_t;
+
+/**
+ * Checks a cell of the current wave.
+ *
+ * In the first phase every cell is checked against the puzzle as it is at the start of the wave, close to a minimal
+ * puzzle most numbers already fail this check and are kept for good. In the second phase the cells which passed are
+ * checked again with every cell before them erased which has not been kept for good.
+ *
+ * @param worker the thread checking the cell
+ * @param check_index the index of the check in the wave
+ */
+static void run_check(dig_worker_t *worker, unsigned check_index) {
+    dig_t *dig = worker->dig;
+    check_t *check = &dig->checks[check_index];
+
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+    memcpy(digits, dig->digits, SMALLDOKU_CELL_COUNT);
+
+    if (dig->phase == 1) {
+        if (check->outcome != CHECK_UNDECIDED || check->status != SMALLDOKU_SOLVE_COMPLETE) {
+            return;
+        }
+
+        int erased = 0;
+        for (unsigned i = 0; i < check_index; i++) {
+            if (dig->checks[i].outcome != CHECK_KEPT) {
+                digits[dig->checks[i].cell] = 0;
+                erased = 1;
+            }
+        }
+
+        if (!erased) {
+            /* Only kept cells come before, the puzzle is exactly the one of the first phase */
+            check->confirmed = 1;
+            return;
+        }
+    }
+
+    smalldoku_solver_t *solver = &dig->solver->solvers[worker->index];
+    smalldoku_dig_options_t options = *dig->options;
+    options.stats = dig->options->stats ? &dig->stats[worker->index] : 0;
+
+    smalldoku_uint64_t start_nodes = atomic_load(&dig->nodes);
+    smalldoku_uint64_t node_count = start_nodes;
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+
+    if (dig->phase == 1) {
+        smalldoku_uint64_t budget = start_nodes + check->nodes * SPECULATION_FACTOR + SPECULATION_MIN_NODES;
+
+        if (options.node_budget == 0 || options.node_budget > budget) {
+            options.node_budget = budget;
+        }
+    }
+
+    int removable = smalldoku_dig_is_removable(solver, digits, check->cell, &options, &node_count, &status);
+    atomic_fetch_add(&dig->nodes, node_count - start_nodes);
+
+    if (dig->phase == 0) {
+        check->outcome = !removable ? CHECK_KEPT : check_index == 0 ? CHECK_REMOVABLE : CHECK_UNDECIDED;
+        check->confirmed = 0;
+        check->given_up = 0;
+        check->nodes = node_count - start_nodes;
+        check->status = status;
+    } else {
+        /* A given up check leaves the cell undecided, the next wave checks it against the exact puzzle */
+        check->confirmed = removable;
+        check->given_up = status != SMALLDOKU_SOLVE_COMPLETE;
+    }
+}
+
+/**
+ * Takes checks of the current wave until none are left.
+ *
+ * @param worker the thread taking checks
+ */
+static void run_wave(dig_worker_t *worker) {
+    dig_t *dig = worker->dig;
+    unsigned check_index;
+
+    while ((check_index = atomic_fetch_add(&dig->next_check, 1)) < dig->check_count) {
+        run_check(worker, check_index);
+    }
+}
+
+static void *run_dig_worker(void *argument) {
+    dig_worker_t *worker = argument;
+    dig_t *dig = worker->dig;
+    unsigned seen_wave = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&dig->lock);
+        while (dig->wave == seen_wave && !dig->done) {
+            pthread_cond_wait(&dig->wave_started, &dig->lock);
+        }
+
+        seen_wave = dig->wave;
+        int done = dig->done;
+        pthread_mutex_unlock(&dig->lock);
+
+        if (done) {
+            return NULL;
+        }
+
+        run_wave(worker);
+
+        pthread_mutex_lock(&dig->lock);
+        dig->finished_workers++;
+        pthread_cond_signal(&dig->wave_finished);
+        pthread_mutex_unlock(&dig->lock);
+    }
+}
+
+smalldoku_cell_index_t smalldoku_parallel_dig_digits(
+        smalldoku_parallel_solver_t *solver,
+        smalldoku_uint8_t *digits,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+) {
+    unsigned thread_count = solver->thread_count;
+    dig_t *dig = malloc(sizeof(dig_t));
+    dig_worker_t *workers = malloc(thread_count * sizeof(dig_worker_t));
+    smalldoku_stats_t *stats = calloc(thread_count, sizeof(smalldoku_stats_t));
+
+    if (options->max_technique != SMALLDOKU_TECHNIQUE_NONE || thread_count == 1 || !dig || !workers || !stats) {
+        free(dig);
+        free(workers);
+        free(stats);
+        return smalldoku_dig_digits(&solver->solvers[0], digits, rng, options);
+    }
+
+    smalldoku_cell_index_t order[SMALLDOKU_CELL_COUNT];
+    smalldoku_dig_order(order, rng);
+
+    smalldoku_cell_index_t clues = 0;
+    for (smalldoku_cell_index_t i = 0; i < SMALLDOKU_CELL_COUNT; i++) {
+        clues += digits[i] != 0;
+    }
+
+    dig->solver = solver;
+    dig->options = options;
+    atomic_init(&dig->nodes, 0);
+    dig->stats = stats;
+    pthread_mutex_init(&dig->lock, NULL);
+    pthread_cond_init(&dig->wave_started, NULL);
+    pthread_cond_init(&dig->wave_finished, NULL);
+    dig->wave = 0;
+    dig->done = 0;
+
+    unsigned started = 1;
+    workers[0].dig = dig;
+    workers[0].index = 0;
+    for (; started < thread_count; started++) {
+        workers[started].dig = dig;
+        workers[started].index = started;
+
+        if (pthread_create(&workers[started].thread, NULL, run_dig_worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    smalldoku_solve_status_t status = SMALLDOKU_SOLVE_COMPLETE;
+    smalldoku_cell_index_t visited = 0;
+
+    while (visited < SMALLDOKU_CELL_COUNT && clues > options->target_clues && status == SMALLDOKU_SOLVE_COMPLETE) {
+        /* Empty cells are visited without a check, like smalldoku_dig_digits skips them */
+        unsigned check_count = 0;
+        for (smalldoku_cell_index_t i = visited; i < SMALLDOKU_CELL_COUNT; i++) {
+            if (check_count == started * CELLS_PER_THREAD) {
+                break;
+            }
+
+            if (digits[order[i]] != 0) {
+                dig->checks[check_count].cell = order[i];
+                dig->checks[check_count].position = i;
+                check_count++;
+            }
+        }
+
+        if (check_count == 0) {
+            break;
+        }
+
+        memcpy(dig->digits, digits, SMALLDOKU_CELL_COUNT);
+        dig->check_count = check_count;
+
+        for (int phase = 0; phase < 2; phase++) {
+            int undecided = 0;
+            for (unsigned i = 0; i < check_count && phase == 1; i++) {
+                undecided |= dig->checks[i].outcome == CHECK_UNDECIDED;
+            }
+
+            if (phase == 1 && !undecided) {
+                break;
+            }
+
+            dig->phase = phase;
+            atomic_store(&dig->next_check, 0);
+
+            pthread_mutex_lock(&dig->lock);
+            dig->finished_workers = 0;
+            dig->wave++;
+            pthread_cond_broadcast(&dig->wave_started);
+            pthread_mutex_unlock(&dig->lock);
+
+            /* The calling thread checks cells as well, its checks are done once it runs out of them */
+            run_wave(&workers[0]);
+
+            pthread_mutex_lock(&dig->lock);
+            while (dig->finished_workers != started - 1) {
+                pthread_cond_wait(&dig->wave_finished, &dig->lock);
+            }
+            pthread_mutex_unlock(&dig->lock);
+        }
+
+        /* Apply the outcomes in visiting order, as long as they don't depend on the cells erased before */
+        int erased_any = 0;
+        int erased_all = 1;
+        unsigned applied = 0;
+
+        for (; applied < check_count && clues > options->target_clues; applied++) {
+            check_t *check = &dig->checks[applied];
+
+            if (check->status != SMALLDOKU_SOLVE_COMPLETE) {
+                /* Like smalldoku_dig_digits the number whose check could not be finished stays */
+                status = check->status;
+                applied++;
+                break;
+            }
+
+            if (check->outcome == CHECK_KEPT) {
+                continue;
+            }
+
+            int erase = check->outcome == CHECK_REMOVABLE || check->confirmed;
+            if (check->outcome == CHECK_UNDECIDED && !check->confirmed) {
+                if (erased_any && (!erased_all || check->given_up)) {
+                    /* The puzzle is not the one of the first phase and no finished check covers it */
+                    break;
+                }
+
+                erase = !erased_any;
+            }
+
+            if (erase) {
+                digits[check->cell] = 0;
+                clues--;
+                erased_any = 1;
+            } else {
+                erased_all = 0;
+            }
+        }
+
+        /* The first check is never undecided, so every wave visits at least one cell */
+        visited = applied < check_count ? dig->checks[applied].position : dig->checks[check_count - 1].position + 1;
+    }
+
+    pthread_mutex_lock(&dig->lock);
+    dig->done = 1;
+    pthread_cond_broadcast(&dig->wave_started);
+    pthread_mutex_unlock(&dig->lock);
+
+    for (unsigned i = 1; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (options->stats) {
+        for (unsigned i = 0; i < started; i++) {
+            options->stats->nodes += stats[i].nodes;
+            options->stats->backtracks += stats[i].backtracks;
+            options->stats->candidate_checks += stats[i].candidate_checks;
+            options->stats->propagations += stats[i].propagations;
+            options->stats->solve_calls += stats[i].solve_calls;
+            if (options->stats->max_depth < stats[i].max_depth) {
+                options->stats->max_depth = stats[i].max_depth;
+            }
+        }
+    }
+
+    if (options->node_count) {
+        *options->node_count = atomic_load(&dig->nodes);
+    }
+
+    if (options->status) {
+        *options->status = status;
+    }
+
+    pthread_mutex_destroy(&dig->lock);
+    pthread_cond_destroy(&dig->wave_started);
+    pthread_cond_destroy(&dig->wave_finished);
+    free(dig);
+    free(workers);
+    free(stats);
+
+    return clues;
+}
+
+smalldoku_cell_index_t smalldoku_parallel_generate_digits(
+        smalldoku_parallel_solver_t *solver,
+        smalldoku_uint8_t *solution,
+        smalldoku_uint8_t *puzzle,
+        smalldoku_rng_t *rng,
+        const smalldoku_dig_options_t *options
+) {
+    if (!smalldoku_generator_fill_digits(solver->units, solution, rng)) {
+        memset(puzzle, 0, SMALLDOKU_CELL_COUNT);
+        return 0;
+    }
+
+    memcpy(puzzle, solution, SMALLDOKU_CELL_COUNT);
+    return smalldoku_parallel_dig_digits(solver, puzzle, rng, options);
+}
@@ -0,0 +1,715 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <smalldoku/smalldoku-split.h>
+
+#include "smalldoku-linux/smalldoku-parallel-solver.h"
+
+/* Subproblems with fewer empty cells are handed to the solver instead of being split further */
+#define LEAF_EMPTY (SMALLDOKU_CELL_COUNT / 3)
+
+/**
+ * A subproblem waiting to be solved.
+ */
+struct task {
+    /**
+     * The values of the subproblem in row major order, 0 for empty cells.
+     */
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+};
+
+typedef struct task task_t;
+
+/**
+ * A branching decision a thread is working through.
+ */
+struct frame {
+    /**
+     * The values of the subproblem branched on, the branching cell still empty.
+     */
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+
+    /**
+     * The cell branched on.
+     */
+    smalldoku_cell_index_t cell;
+
+    /**
+     * The numbers of the cell which have neither been tried nor given away yet.
+     */
+    smalldoku_number_mask_t remaining;
+};
+
+typedef struct frame frame_t;
+
+/**
+ * The subproblems of a single thread, the owner works on the newest end while thieves take from the oldest end.
+ */
+struct deque {
+    pthread_mutex_t lock;
+
+    /**
+     * The subproblems, the oldest one at head and the newest one before tail.
+     */
+    task_t *tasks;
+
+    size_t head;
+    size_t tail;
+    size_t capacity;
+};
+
+typedef struct deque deque_t;
+
+/**
+ * The state shared by all threads of a single solve.
+ */
+struct search {
+    smalldoku_parallel_solver_t *solver;
+    const smalldoku_solve_options_t *options;
+
+    /**
+     * One deque per thread.
+     */
+    deque_t *deques;
+
+    /**
+     * The amount of subproblems which have not been finished yet, whether waiting or being worked on.
+     */
+    atomic_size_t pending;
+
+    /**
+     * The amount of subproblems waiting in the deques.
+     */
+    atomic_size_t waiting;
+
+    /**
+     * The amount of threads looking for work.
+     */
+    atomic_uint idle;
+
+    /**
+     * The amount of threads which have not returned yet.
+     */
+    atomic_uint running;
+
+    /**
+     * Raised to stop all threads, polled by their solvers. It doubles as the cancellation flag the solvers poll through
+     * an int pointer, so instead of being an atomic_int it is only accessed with __atomic builtins.
+     */
+    int stop;
+
+    /**
+     * The reason the search stopped early, SMALLDOKU_SOLVE_COMPLETE while it runs.
+     */
+    atomic_int status;
+
+    atomic_uint_fast64_t solutions;
+    atomic_uint_fast64_t nodes;
+
+    /**
+     * Serializes the visitor and the first solution.
+     */
+    pthread_mutex_t result_lock;
+    int has_first_solution;
+
+    /**
+     * Signalled whenever subproblems have been pushed while threads are idle, the search stopped or all subproblems
+     * have been finished.
+     */
+    pthread_mutex_t idle_lock;
+    pthread_cond_t work_available;
+};
+
+typedef struct search search_t;
+
+/**
+ * The state of a single thread.
+ */
+struct worker {
+    search_t *search;
+    unsigned index;
+    smalldoku_stats_t stats;
+    pthread_t thread;
+
+    /**
+     * The branching decisions above the subproblem being worked on, the shallowest first. One more frame than
+     * decisions is allocated, the last one holds the subproblem itself.
+     */
+    frame_t *frames;
+};
+
+typedef struct worker worker_t;
+
+/**
+ * Wakes up all threads waiting for work.
+ *
+ * @param search the running search
+ */
+static void wake_idle(search_t *search) {
+    pthread_mutex_lock(&search->idle_lock);
+    pthread_cond_broadcast(&search->work_available);
+    pthread_mutex_unlock(&search->idle_lock);
+}
+
+/**
+ * Checks whether the search has been stopped.
+ *
+ * @param search the search to check
+ * @return 1 if the threads should stop, 0 otherwise
+ */
+static inline int stopped(const search_t *search) {
+    return __atomic_load_n(&search->stop, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Stops the search, keeping the reason of the first stop.
+ *
+ * @param search the search to stop
+ * @param status the reason to stop
+ */
+static void stop_search(search_t *search, smalldoku_solve_status_t status) {
+    int expected = SMALLDOKU_SOLVE_COMPLETE;
+    atomic_compare_exchange_strong(&search->status, &expected, (int) status);
+    __atomic_store_n(&search->stop, 1, __ATOMIC_SEQ_CST);
+    wake_idle(search);
+}
+
+/**
+ * Pushes a subproblem onto the newest end of a deque.
+ *
+ * @param search the search the subproblem belongs to
+ * @param deque the deque to push onto
+ * @param digits the values of the subproblem
+ * @return 1 if the subproblem has been pushed, 0 if the deque could not grow
+ */
+static int deque_push(search_t *search, deque_t *deque, const smalldoku_uint8_t *digits) {
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->tail == deque->capacity) {
+        if (deque->head > 0) {
+            memmove(deque->tasks, deque->tasks + deque->head, (deque->tail - deque->head) * sizeof(task_t));
+            deque->tail -= deque->head;
+            deque->head = 0;
+        } else {
+            size_t capacity = deque->capacity ? deque->capacity * 2 : 64;
+            task_t *tasks = realloc(deque->tasks, capacity * sizeof(task_t));
+
+            if (!tasks) {
+                pthread_mutex_unlock(&deque->lock);
+                return 0;
+            }
+
+            deque->tasks = tasks;
+            deque->capacity = capacity;
+        }
+    }
+
+    memcpy(deque->tasks[deque->tail++].digits, digits, SMALLDOKU_CELL_COUNT);
+    atomic_fetch_add(&search->pending, 1);
+    atomic_fetch_add(&search->waiting, 1);
+
+    pthread_mutex_unlock(&deque->lock);
+
+    if (atomic_load(&search->idle) > 0) {
+        wake_idle(search);
+    }
+
+    return 1;
+}
+
+/**
+ * Takes a subproblem from a deque.
+ *
+ * @param search the search the subproblem belongs to
+ * @param deque the deque to take from
+ * @param newest whether to take the newest (owner) or the oldest (thief) subproblem
+ * @param digits the buffer to write the values of the subproblem to
+ * @return 1 if a subproblem has been taken, 0 if the deque was empty
+ */
+static int deque_take(search_t *search, deque_t *deque, int newest, smalldoku_uint8_t *digits) {
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->head == deque->tail) {
+        pthread_mutex_unlock(&deque->lock);
+        return 0;
+    }
+
+    task_t *task = newest ? &deque->tasks[--deque->tail] : &deque->tasks[deque->head++];
+    memcpy(digits, task->digits, SMALLDOKU_CELL_COUNT);
+
+    if (deque->head == deque->tail) {
+        deque->head = 0;
+        deque->tail = 0;
+    }
+
+    atomic_fetch_sub(&search->waiting, 1);
+
+    pthread_mutex_unlock(&deque->lock);
+    return 1;
+}
+
+/**
+ * Whether other threads would benefit from more subproblems.
+ *
+ * @param search the running search
+ * @return 1 if fewer subproblems are waiting than there are threads or a thread is out of work
+ */
+static int is_starving(search_t *search) {
+    return atomic_load(&search->idle) > 0 || atomic_load(&search->waiting) < search->solver->thread_count;
+}
+
+/**
+ * Records the solutions found for a subproblem.
+ *
+ * @param search the running search
+ * @param count the amount of solutions found
+ * @param solution one of the solutions, only read if count is not 0
+ */
+static void add_solutions(search_t *search, smalldoku_uint64_t count, const smalldoku_uint8_t *solution) {
+    if (count == 0) {
+        return;
+    }
+
+    const smalldoku_solve_options_t *options = search->options;
+    if (options->first_solution) {
+        pthread_mutex_lock(&search->result_lock);
+        if (!search->has_first_solution) {
+            memcpy(options->first_solution, solution, SMALLDOKU_CELL_COUNT);
+            search->has_first_solution = 1;
+        }
+        pthread_mutex_unlock(&search->result_lock);
+    }
+
+    smalldoku_uint64_t total = atomic_fetch_add(&search->solutions, count) + count;
+    if (options->solution_limit != 0 && total >= options->solution_limit) {
+        stop_search(search, SMALLDOKU_SOLVE_STOPPED);
+    }
+}
+
+/**
+ * Visitor installed while a visitor has been set, counting every solution the moment it is reported.
+ */
+static int visit_solution(const smalldoku_uint8_t *solution, void *user_data) {
+    search_t *search = user_data;
+    const smalldoku_solve_options_t *options = search->options;
+
+    pthread_mutex_lock(&search->result_lock);
+
+    if (stopped(search)) {
+        pthread_mutex_unlock(&search->result_lock);
+        return 0;
+    }
+
+    if (options->first_solution && !search->has_first_solution) {
+        memcpy(options->first_solution, solution, SMALLDOKU_CELL_COUNT);
+        search->has_first_solution = 1;
+    }
+
+    smalldoku_uint64_t total = atomic_fetch_add(&search->solutions, 1) + 1;
+    int keep_going = options->visitor(solution, options->visitor_data);
+
+    if (!keep_going || (options->solution_limit != 0 && total >= options->solution_limit)) {
+        stop_search(search, SMALLDOKU_SOLVE_STOPPED);
+    }
+
+    pthread_mutex_unlock(&search->result_lock);
+    return keep_going;
+}
+
+/**
+ * Solves a subproblem with the solver of a thread.
+ *
+ * @param worker the thread solving the subproblem
+ * @param digits the values of the subproblem
+ */
+static void solve_leaf(worker_t *worker, const smalldoku_uint8_t *digits) {
+    search_t *search = worker->search;
+    const smalldoku_solve_options_t *options = search->options;
+
+    smalldoku_uint64_t budget = 0;
+    if (options->node_budget != 0) {
+        smalldoku_uint64_t used = atomic_load(&search->nodes);
+        if (used >= options->node_budget) {
+            stop_search(search, SMALLDOKU_SOLVE_BUDGET_EXHAUSTED);
+            return;
+        }
+
+        budget = options->node_budget - used;
+    }
+
+    smalldoku_uint32_t limit = 0;
+    if (options->solution_limit != 0) {
+        smalldoku_uint64_t found = atomic_load(&search->solutions);
+        if (found >= options->solution_limit) {
+            return;
+        }
+
+        limit = options->solution_limit - found;
+    }
+
+    smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+    smalldoku_uint64_t node_count = 0;
+    smalldoku_solve_status_t status;
+    smalldoku_solve_options_t leaf_options = {
+            limit,
+            options->visitor ? 0 : solution,
+            options->visitor ? visit_solution : 0,
+            search,
+            &node_count,
+            &worker->stats,
+            budget,
+            &search->stop,
+            &status
+    };
+
+    smalldoku_uint32_t count = smalldoku_solver_solve_digits(
+            &search->solver->solvers[worker->index],
+            digits,
+            &leaf_options
+    );
+    atomic_fetch_add(&search->nodes, node_count);
+
+    if (!options->visitor) {
+        add_solutions(search, count, solution);
+    }
+
+    if (status == SMALLDOKU_SOLVE_BUDGET_EXHAUSTED) {
+        stop_search(search, SMALLDOKU_SOLVE_BUDGET_EXHAUSTED);
+    }
+}
+
+/**
+ * Expands a subproblem, solving it right away if it is solved by propagation or small enough.
+ *
+ * @param worker the thread expanding the subproblem
+ * @param frame the frame holding the subproblem, receives the branching decision
+ * @return 1 if the frame needs to be branched on, 0 if the subproblem has been finished
+ */
+static int expand(worker_t *worker, frame_t *frame) {
+    search_t *search = worker->search;
+    smalldoku_split_t split;
+
+    switch (smalldoku_split_digits(search->solver->units, frame->digits, &split)) {
+        case SMALLDOKU_SPLIT_CONTRADICTION:
+            return 0;
+
+        case SMALLDOKU_SPLIT_SOLVED:
+            if (search->options->visitor) {
+                visit_solution(frame->digits, search);
+            } else {
+                add_solutions(search, 1, frame->digits);
+            }
+            return 0;
+
+        case SMALLDOKU_SPLIT_BRANCH:
+            break;
+    }
+
+    if (split.empty < LEAF_EMPTY) {
+        solve_leaf(worker, frame->digits);
+        return 0;
+    }
+
+    frame->cell = split.cell;
+    frame->remaining = split.candidates;
+    return 1;
+}
+
+/**
+ * Gives the untried numbers of the shallowest decision with any left to the other threads.
+ *
+ * The shallowest decisions lead to the largest subproblems, so thieves get as much work as possible per steal.
+ *
+ * @param worker the thread giving work away
+ * @param depth the amount of decisions of the thread
+ */
+static void donate(worker_t *worker, smalldoku_cell_index_t depth) {
+    search_t *search = worker->search;
+
+    for (smalldoku_cell_index_t level = 0; level < depth; level++) {
+        frame_t *frame = &worker->frames[level];
+        if (frame->remaining == 0) {
+            continue;
+        }
+
+        for (smalldoku_uint8_t number = 1; number <= SMALLDOKU_GRID_WIDTH; number++) {
+            if (!(frame->remaining & (1ul << (number - 1)))) {
+                continue;
+            }
+
+            frame->digits[frame->cell] = number;
+            if (!deque_push(search, &search->deques[worker->index], frame->digits)) {
+                /* Out of memory, the thread keeps the rest of the numbers */
+                break;
+            }
+
+            frame->remaining &= ~(1ul << (number - 1));
+        }
+
+        frame->digits[frame->cell] = 0;
+        return;
+    }
+}
+
+/**
+ * Solves a subproblem depth first, giving parts of it away whenever other threads are starving.
+ *
+ * @param worker the thread solving the subproblem
+ * @param digits the values of the subproblem
+ */
+static void solve_task(worker_t *worker, const smalldoku_uint8_t *digits) {
+    search_t *search = worker->search;
+    frame_t *frames = worker->frames;
+
+    memcpy(frames[0].digits, digits, SMALLDOKU_CELL_COUNT);
+    smalldoku_cell_index_t depth = expand(worker, &frames[0]);
+
+    while (depth > 0 && !stopped(search)) {
+        if (is_starving(search)) {
+            donate(worker, depth);
+        }
+
+        frame_t *frame = &frames[depth - 1];
+        if (frame->remaining == 0) {
+            depth--;
+            continue;
+        }
+
+        smalldoku_uint8_t number = __builtin_ctz(frame->remaining) + 1;
+        frame->remaining &= ~(1ul << (number - 1));
+
+        frame_t *child = &frames[depth];
+        memcpy(child->digits, frame->digits, SMALLDOKU_CELL_COUNT);
+        child->digits[frame->cell] = number;
+
+        depth += expand(worker, child);
+    }
+}
+
+/**
+ * Takes the next subproblem of a thread, from its own deque or stolen from another.
+ *
+ * @param worker the thread looking for work
+ * @param digits the buffer to write the values of the subproblem to
+ * @return 1 if a subproblem has been taken, 0 if the search is over
+ */
+static int take_task(worker_t *worker, smalldoku_uint8_t *digits) {
+    search_t *search = worker->search;
+    unsigned thread_count = search->solver->thread_count;
+
+    if (deque_take(search, &search->deques[worker->index], 1, digits)) {
+        return 1;
+    }
+
+    atomic_fetch_add(&search->idle, 1);
+
+    while (!stopped(search) && atomic_load(&search->pending) != 0) {
+        for (unsigned i = 1; i < thread_count; i++) {
+            unsigned victim = (worker->index + i) % thread_count;
+
+            if (deque_take(search, &search->deques[victim], 0, digits)) {
+                atomic_fetch_sub(&search->idle, 1);
+                return 1;
+            }
+        }
+
+        if (deque_take(search, &search->deques[worker->index], 1, digits)) {
+            atomic_fetch_sub(&search->idle, 1);
+            return 1;
+        }
+
+        /* A pusher increments waiting before looking at idle, so either it wakes this thread or the check sees the
+         * new subproblem */
+        pthread_mutex_lock(&search->idle_lock);
+        if (!stopped(search) && atomic_load(&search->pending) != 0 && atomic_load(&search->waiting) == 0) {
+            pthread_cond_wait(&search->work_available, &search->idle_lock);
+        }
+        pthread_mutex_unlock(&search->idle_lock);
+    }
+
+    atomic_fetch_sub(&search->idle, 1);
+    return 0;
+}
+
+static void *run_worker(void *argument) {
+    worker_t *worker = argument;
+    search_t *search = worker->search;
+    smalldoku_uint8_t digits[SMALLDOKU_CELL_COUNT];
+
+    while (take_task(worker, digits)) {
+        if (!stopped(search)) {
+            solve_task(worker, digits);
+        }
+
+        if (atomic_fetch_sub(&search->pending, 1) == 1) {
+            wake_idle(search);
+        }
+    }
+
+    atomic_fetch_sub(&search->running, 1);
+    return NULL;
+}
+
+int smalldoku_parallel_solver_init(
+        smalldoku_parallel_solver_t *solver,
+        const smalldoku_solver_config_t *config,
+        unsigned thread_count
+) {
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (unsigned) online : 1;
+    }
+
+    solver->solvers = malloc(thread_count * sizeof(smalldoku_solver_t));
+    if (!solver->solvers) {
+        return 0;
+    }
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        smalldoku_solver_init(&solver->solvers[i], config);
+    }
+
+    solver->thread_count = thread_count;
+    solver->units = solver->solvers[0].units;
+
+    return 1;
+}
+
+void smalldoku_parallel_solver_destroy(smalldoku_parallel_solver_t *solver) {
+    free(solver->solvers);
+    solver->solvers = NULL;
+    solver->thread_count = 0;
+}
+
+smalldoku_uint32_t smalldoku_parallel_solver_solve_digits(
+        smalldoku_parallel_solver_t *solver,
+        const smalldoku_uint8_t *digits,
+        const smalldoku_solve_options_t *options
+) {
+    unsigned thread_count = solver->thread_count;
+    search_t search;
+
+    search.solver = solver;
+    search.options = options;
+    atomic_init(&search.pending, 0);
+    atomic_init(&search.waiting, 0);
+    atomic_init(&search.idle, 0);
+    atomic_init(&search.running, thread_count);
+    search.stop = 0;
+    atomic_init(&search.status, SMALLDOKU_SOLVE_COMPLETE);
+    atomic_init(&search.solutions, 0);
+    atomic_init(&search.nodes, 0);
+    pthread_mutex_init(&search.result_lock, NULL);
+    search.has_first_solution = 0;
+    pthread_mutex_init(&search.idle_lock, NULL);
+    pthread_cond_init(&search.work_available, NULL);
+
+    deque_t *deques = calloc(thread_count, sizeof(deque_t));
+    worker_t *workers = calloc(thread_count, sizeof(worker_t));
+    frame_t *frames = malloc(thread_count * (SMALLDOKU_CELL_COUNT + 1) * sizeof(frame_t));
+
+    if (!deques || !workers || !frames) {
+        /* Not even the bookkeeping fits, fall back to a single thread */
+        free(deques);
+        free(workers);
+        free(frames);
+        pthread_mutex_destroy(&search.result_lock);
+        pthread_mutex_destroy(&search.idle_lock);
+        pthread_cond_destroy(&search.work_available);
+        return smalldoku_solver_solve_digits(&solver->solvers[0], digits, options);
+    }
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        pthread_mutex_init(&deques[i].lock, NULL);
+    }
+    search.deques = deques;
+
+    deque_push(&search, &deques[0], digits);
+
+    unsigned started = 0;
+    for (; started < thread_count; started++) {
+        workers[started].search = &search;
+        workers[started].index = started;
+        workers[started].frames = frames + started * (SMALLDOKU_CELL_COUNT + 1);
+
+        if (started != 0 && pthread_create(&workers[started].thread, NULL, run_worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    /* Threads which could not be started never run, the calling thread works as the first one */
+    atomic_fetch_sub(&search.running, thread_count - started);
+
+    if (options->cancel) {
+        /* The solvers only poll a single flag, so a helper thread takes over the first thread's work while the
+         * calling thread forwards the cancellation flag */
+        pthread_t first;
+
+        if (pthread_create(&first, NULL, run_worker, &workers[0]) == 0) {
+            struct timespec interval = {0, 1000000};
+
+            while (atomic_load(&search.running) != 0) {
+                if (*options->cancel) {
+                    stop_search(&search, SMALLDOKU_SOLVE_CANCELLED);
+                }
+
+                nanosleep(&interval, NULL);
+            }
+
+            pthread_join(first, NULL);
+        } else {
+            run_worker(&workers[0]);
+        }
+    } else {
+        run_worker(&workers[0]);
+    }
+
+    for (unsigned i = 1; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (options->stats) {
+        for (unsigned i = 0; i < started; i++) {
+            smalldoku_stats_t *stats = &workers[i].stats;
+
+            options->stats->nodes += stats->nodes;
+            options->stats->backtracks += stats->backtracks;
+            options->stats->candidate_checks += stats->candidate_checks;
+            options->stats->propagations += stats->propagations;
+            options->stats->solve_calls += stats->solve_calls;
+            if (options->stats->max_depth < stats->max_depth) {
+                options->stats->max_depth = stats->max_depth;
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        pthread_mutex_destroy(&deques[i].lock);
+        free(deques[i].tasks);
+    }
+    free(deques);
+    free(workers);
+    free(frames);
+    pthread_mutex_destroy(&search.result_lock);
+    pthread_mutex_destroy(&search.idle_lock);
+    pthread_cond_destroy(&search.work_available);
+
+    smalldoku_uint64_t solutions = atomic_load(&search.solutions);
+    if (options->solution_limit != 0 && solutions > options->solution_limit) {
+        solutions = options->solution_limit;
+    }
+
+    if (options->node_count) {
+        *options->node_count = atomic_load(&search.nodes);
+    }
+
+    if (options->status) {
+        *options->status = (smalldoku_solve_status_t) atomic_load(&search.status);
+    }
+
+    return (smalldoku_uint32_t) solutions;
+}
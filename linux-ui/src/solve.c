@@ -0,0 +1,580 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <smalldoku/smalldoku-memory.h>
+#include <smalldoku/smalldoku-solver.h>
+#include <smalldoku/smalldoku-text.h>
+
+#include "smalldoku-linux/smalldoku-line-reader.h"
+#include "smalldoku-linux/smalldoku-parallel-solver.h"
+
+/* The amount of puzzles handed to a thread at once, enough to make the synchronization per batch negligible */
+#define BATCH_SIZE 1024
+
+/* How long the reader waits for input at a time while the input stalls, writing solved batches in between */
+#define STALL_POLL_MS 1
+
+/* The longest line written for a puzzle: its solution, its solution count or a marker, plus the line break */
+#define OUTPUT_LINE_SIZE ((SMALLDOKU_TEXT_LENGTH > 20 ? SMALLDOKU_TEXT_LENGTH : 20) + 1)
+
+/**
+ * What the solver writes and how it works, as given on the command line.
+ */
+struct solve_options {
+    /**
+     * Whether to write the amount of solutions instead of the first solution.
+     */
+    int count;
+
+    /**
+     * The amount of solutions after which counting stops, 0 to count all.
+     */
+    smalldoku_uint32_t limit;
+
+    /**
+     * The amount of threads solving, 1 to solve on the thread reading the input.
+     */
+    unsigned thread_count;
+
+    /**
+     * Whether all threads solve every single puzzle together instead of each thread solving puzzles of its own.
+     */
+    int parallel;
+
+    smalldoku_solver_config_t config;
+
+    /**
+     * Whether to report the amount of puzzles and the rate to the standard error.
+     */
+    int verbose;
+};
+
+typedef struct solve_options solve_options_t;
+
+/**
+ * The stages a batch goes through, it is only ever touched by the thread owning the stage.
+ */
+enum batch_state {
+    /**
+     * The reader fills the batch with puzzles.
+     */
+    BATCH_FREE,
+
+    /**
+     * A solver thread solves the puzzles and writes the output.
+     */
+    BATCH_FILLED,
+
+    /**
+     * The reader writes the output once all batches before have been written.
+     */
+    BATCH_SOLVED
+};
+
+typedef enum batch_state batch_state_t;
+
+/**
+ * Consecutive puzzles of the input and the output for them.
+ */
+struct batch {
+    smalldoku_uint8_t puzzles[BATCH_SIZE][SMALLDOKU_CELL_COUNT];
+
+    /**
+     * Whether the line of a puzzle could be read, lines which could not are answered with a marker.
+     */
+    smalldoku_uint8_t valid[BATCH_SIZE];
+    unsigned count;
+
+    char output[BATCH_SIZE * OUTPUT_LINE_SIZE];
+    size_t output_size;
+
+    batch_state_t state;
+};
+
+typedef struct batch batch_t;
+
+/**
+ * The ring of batches shared by the reader and the solver threads.
+ *
+ * Batches are numbered in input order. The reader fills batch n into the slot n modulo the slot count, solver threads
+ * take filled batches in order, and the reader writes the output of batch n only after the output of all batches
+ * before it, so the output stays in input order however the solves interleave.
+ */
+struct pipeline {
+    const solve_options_t *options;
+
+    batch_t *batches;
+    unsigned batch_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t batch_filled;
+    pthread_cond_t batch_solved;
+
+    /**
+     * The amount of batches filled and the amount taken by solver threads so far.
+     */
+    unsigned long filled;
+    unsigned long taken;
+
+    /**
+     * Set once the input has been read completely, the solver threads go home.
+     */
+    int done;
+};
+
+typedef struct pipeline pipeline_t;
+
+/**
+ * A solver thread, or the reader if it solves on its own.
+ */
+struct worker {
+    pipeline_t *pipeline;
+    pthread_t thread;
+    smalldoku_solver_t solver;
+
+    /**
+     * The solver searching each puzzle on all threads, used instead of the solver if not NULL.
+     */
+    smalldoku_parallel_solver_t *parallel;
+};
+
+typedef struct worker worker_t;
+
+/**
+ * Writes a number in decimal.
+ *
+ * @param out the buffer to write to
+ * @param value the number to write
+ * @return the amount of characters written
+ */
+static size_t format_count(char *out, smalldoku_uint32_t value) {
+    char digits[10];
+    size_t length = 0;
+
+    do {
+        digits[length++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    for (size_t i = 0; i < length; i++) {
+        out[i] = digits[length - 1 - i];
+    }
+
+    return length;
+}
+
+/**
+ * Solves all puzzles of a batch and writes the output for them into the batch.
+ *
+ * @param worker the worker whose solver to use
+ * @param options the options of the run
+ * @param batch the batch to solve
+ */
+static void solve_batch(worker_t *worker, const solve_options_t *options, batch_t *batch) {
+    char *out = batch->output;
+    smalldoku_uint8_t solution[SMALLDOKU_CELL_COUNT];
+
+    smalldoku_solve_options_t solve_options = {
+            options->count ? options->limit : 1, options->count ? NULL : solution, NULL, NULL, NULL, NULL, 0, NULL, NULL
+    };
+
+    for (unsigned i = 0; i < batch->count; i++) {
+        if (!batch->valid[i]) {
+            memcpy(out, "invalid\n", 8);
+            out += 8;
+            continue;
+        }
+
+        smalldoku_uint32_t solutions;
+        if (worker->parallel) {
+            solutions = smalldoku_parallel_solver_solve_digits(worker->parallel, batch->puzzles[i], &solve_options);
+        } else {
+            solutions = smalldoku_solver_solve_digits(&worker->solver, batch->puzzles[i], &solve_options);
+        }
+
+        if (options->count) {
+            out += format_count(out, solutions);
+        } else if (solutions == 0) {
+            memcpy(out, "none", 4);
+            out += 4;
+        } else {
+            smalldoku_text_format_digits(solution, out);
+            out += SMALLDOKU_TEXT_LENGTH;
+        }
+
+        *out++ = '\n';
+    }
+
+    batch->output_size = out - batch->output;
+}
+
+static void *run_worker(void *argument) {
+    worker_t *worker = argument;
+    pipeline_t *pipeline = worker->pipeline;
+
+    for (;;) {
+        pthread_mutex_lock(&pipeline->lock);
+        while (pipeline->taken == pipeline->filled && !pipeline->done) {
+            pthread_cond_wait(&pipeline->batch_filled, &pipeline->lock);
+        }
+
+        if (pipeline->taken == pipeline->filled) {
+            pthread_mutex_unlock(&pipeline->lock);
+            return NULL;
+        }
+
+        batch_t *batch = &pipeline->batches[pipeline->taken++ % pipeline->batch_count];
+        pthread_mutex_unlock(&pipeline->lock);
+
+        solve_batch(worker, pipeline->options, batch);
+
+        pthread_mutex_lock(&pipeline->lock);
+        batch->state = BATCH_SOLVED;
+        pthread_cond_broadcast(&pipeline->batch_solved);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+}
+
+/**
+ * Writes the output of a batch once it has been solved and frees it for the reader.
+ *
+ * @param pipeline the pipeline the batch belongs to
+ * @param sequence the number of the batch
+ * @return 1 if the output has been written, 0 if writing failed
+ */
+static int write_batch(pipeline_t *pipeline, unsigned long sequence) {
+    batch_t *batch = &pipeline->batches[sequence % pipeline->batch_count];
+
+    pthread_mutex_lock(&pipeline->lock);
+    while (batch->state != BATCH_SOLVED) {
+        pthread_cond_wait(&pipeline->batch_solved, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+
+    size_t written = fwrite(batch->output, 1, batch->output_size, stdout);
+    batch->state = BATCH_FREE;
+
+    return written == batch->output_size;
+}
+
+/**
+ * Writes the output of all batches solved so far which are next in order, without waiting for any batch.
+ *
+ * @param pipeline the pipeline the batches belong to
+ * @param sequence the number of batches handed off so far
+ * @param written the number of batches written so far, advanced past the batches written
+ * @return 1 if the output has been written, 0 if writing failed
+ */
+static int write_solved_batches(pipeline_t *pipeline, unsigned long sequence, unsigned long *written) {
+    while (*written < sequence) {
+        pthread_mutex_lock(&pipeline->lock);
+        int solved = pipeline->batches[*written % pipeline->batch_count].state == BATCH_SOLVED;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        if (!solved) {
+            break;
+        }
+
+        if (!write_batch(pipeline, (*written)++)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Hands a filled batch to the solver threads, or solves it right away without any.
+ *
+ * @param pipeline the pipeline the batch belongs to
+ * @param batch the batch to hand off
+ * @param self the worker of the reader, used if there are no solver threads, NULL otherwise
+ */
+static void submit_batch(pipeline_t *pipeline, batch_t *batch, worker_t *self) {
+    if (self) {
+        solve_batch(self, pipeline->options, batch);
+        batch->state = BATCH_SOLVED;
+        pipeline->filled++;
+        pipeline->taken++;
+        return;
+    }
+
+    pthread_mutex_lock(&pipeline->lock);
+    batch->state = BATCH_FILLED;
+    pipeline->filled++;
+    pthread_cond_signal(&pipeline->batch_filled);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static void print_usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-c] [-l limit] [-j threads] [-p] [-b backtrack|dlx|bitboard] [-v] [file...]\n"
+            "Solves puzzles given one per line as %d characters, 1-9 and A-Z for numbers and . or 0 for empty cells.\n"
+            "Reads the standard input if no file (or -) is given and writes one line per puzzle: its first solution,\n"
+            "none if it has no solution or invalid if the line holds no puzzle. Empty lines and lines starting with #\n"
+            "are skipped.\n"
+            "  -c  write the amount of solutions instead, counting up to the limit\n"
+            "  -l  the amount of solutions to stop counting at, 0 for no limit (default 2)\n"
+            "  -j  the amount of threads to solve on, 0 for one per processor (default 1)\n"
+            "  -p  solve every puzzle on all threads together, for few hard puzzles instead of many easy ones\n"
+            "  -b  the solver backend to use (default bitboard)\n"
+            "  -v  report the amount of puzzles solved and the rate to the standard error\n",
+            name, SMALLDOKU_TEXT_LENGTH);
+}
+
+/**
+ * Reads the command line.
+ *
+ * @param argc the amount of arguments
+ * @param argv the arguments
+ * @param options the options to fill
+ * @return the index of the first file argument, or -1 if the command line is malformed
+ */
+static int parse_arguments(int argc, char **argv, solve_options_t *options) {
+    options->count = 0;
+    options->limit = 2;
+    options->thread_count = 1;
+    options->parallel = 0;
+    options->config.backend = SMALLDOKU_SOLVER_BITBOARD;
+    options->config.branching = SMALLDOKU_BRANCH_MOST_CONSTRAINED;
+    options->config.propagation = SMALLDOKU_PROPAGATE_SINGLES;
+    options->config.units = NULL;
+    options->verbose = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "cl:j:pb:vh")) != -1) {
+        switch (option) {
+            case 'c':
+                options->count = 1;
+                break;
+
+            case 'l':
+                options->limit = (smalldoku_uint32_t) strtoul(optarg, NULL, 0);
+                break;
+
+            case 'j':
+                options->thread_count = (unsigned) strtoul(optarg, NULL, 0);
+                break;
+
+            case 'p':
+                options->parallel = 1;
+                break;
+
+            case 'b':
+                if (strcmp(optarg, "backtrack") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_BACKTRACK;
+                } else if (strcmp(optarg, "dlx") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_DLX;
+                } else if (strcmp(optarg, "bitboard") == 0) {
+                    options->config.backend = SMALLDOKU_SOLVER_BITBOARD;
+                } else {
+                    fprintf(stderr, "Unknown solver backend %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'v':
+                options->verbose = 1;
+                break;
+
+            default:
+                return -1;
+        }
+    }
+
+    if (options->thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        options->thread_count = online > 0 ? (unsigned) online : 1;
+    }
+
+    return optind;
+}
+
+int main(int argc, char **argv) {
+    smalldoku_memory_init();
+
+    solve_options_t options;
+    int first_file = parse_arguments(argc, argv, &options);
+    if (first_file < 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    /* A single thread solves on the reader, more threads solve while the reader reads ahead and writes in order. If
+     * they solve each puzzle together the reader waits for them anyway, so it hands every batch over itself. */
+    int pipelined = options.thread_count > 1 && !options.parallel;
+    unsigned worker_count = pipelined ? options.thread_count : 1;
+    unsigned batch_count = pipelined ? 2 * options.thread_count : 1;
+
+    pipeline_t pipeline;
+    pipeline.options = &options;
+    pipeline.batches = malloc(batch_count * sizeof(batch_t));
+    pipeline.batch_count = batch_count;
+    pthread_mutex_init(&pipeline.lock, NULL);
+    pthread_cond_init(&pipeline.batch_filled, NULL);
+    pthread_cond_init(&pipeline.batch_solved, NULL);
+    pipeline.filled = 0;
+    pipeline.taken = 0;
+    pipeline.done = 0;
+
+    worker_t *workers = malloc(worker_count * sizeof(worker_t));
+    if (!pipeline.batches || !workers) {
+        fprintf(stderr, "Out of memory!\n");
+        return 1;
+    }
+
+    for (unsigned i = 0; i < batch_count; i++) {
+        pipeline.batches[i].state = BATCH_FREE;
+    }
+
+    unsigned started = 0;
+    for (unsigned i = 0; i < worker_count; i++) {
+        workers[i].pipeline = &pipeline;
+        workers[i].parallel = NULL;
+        smalldoku_solver_init(&workers[i].solver, &options.config);
+    }
+
+    smalldoku_parallel_solver_t parallel;
+    if (options.parallel) {
+        if (!smalldoku_parallel_solver_init(&parallel, &options.config, options.thread_count)) {
+            fprintf(stderr, "Out of memory!\n");
+            return 1;
+        }
+
+        workers[0].parallel = &parallel;
+    }
+
+    if (pipelined) {
+        for (; started < worker_count; started++) {
+            if (pthread_create(&workers[started].thread, NULL, run_worker, &workers[started]) != 0) {
+                break;
+            }
+        }
+    }
+
+    /* Without any solver thread the reader solves the batches itself */
+    worker_t *self = started == 0 ? &workers[0] : NULL;
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    int status = 0;
+    unsigned long puzzle_count = 0;
+    unsigned long invalid_count = 0;
+    unsigned long sequence = 0;
+    unsigned long written = 0;
+    batch_t *batch = NULL;
+
+    int file_count = argc - first_file;
+    for (int file = 0; file < (file_count > 0 ? file_count : 1) && status == 0; file++) {
+        const char *path = file_count > 0 ? argv[first_file + file] : "-";
+
+        smalldoku_line_reader_t reader;
+        if (!smalldoku_line_reader_open(&reader, path)) {
+            fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+            status = 1;
+            break;
+        }
+
+        const char *line;
+        size_t length;
+        while (status == 0 && smalldoku_line_reader_next(&reader, &line, &length)) {
+            if (length == 0 || line[0] == '#' || (length == 1 && line[0] == '\r')) {
+                continue;
+            }
+
+            if (!batch) {
+                /* The slot of the next batch is free once the batch using it before has been written */
+                if (sequence - written == batch_count && !write_batch(&pipeline, written++)) {
+                    status = 1;
+                    break;
+                }
+
+                batch = &pipeline.batches[sequence % batch_count];
+                batch->count = 0;
+            }
+
+            unsigned index = batch->count++;
+            batch->valid[index] = (smalldoku_uint8_t) smalldoku_text_parse_digits(line, length, batch->puzzles[index]);
+            invalid_count += !batch->valid[index];
+            puzzle_count++;
+
+            int would_block = smalldoku_line_reader_would_block(&reader);
+            if (batch->count == BATCH_SIZE || would_block) {
+                submit_batch(&pipeline, batch, self);
+                batch = NULL;
+                sequence++;
+            }
+
+            /* The input stalls, write the output of the solves finishing meanwhile until more input arrives */
+            while (would_block && status == 0) {
+                if (!write_solved_batches(&pipeline, sequence, &written) || fflush(stdout) != 0) {
+                    status = 1;
+                }
+
+                would_block = written < sequence && !smalldoku_line_reader_wait(&reader, STALL_POLL_MS);
+            }
+        }
+
+        if (reader.error) {
+            fprintf(stderr, "Failed to read %s: %s\n", path, strerror(errno));
+            status = 1;
+        }
+
+        smalldoku_line_reader_close(&reader);
+    }
+
+    if (batch) {
+        submit_batch(&pipeline, batch, self);
+        sequence++;
+    }
+
+    while (written < sequence) {
+        if (!write_batch(&pipeline, written++)) {
+            status = 1;
+        }
+    }
+
+    if (fflush(stdout) != 0) {
+        status = 1;
+    }
+
+    if (status != 0 && ferror(stdout)) {
+        fprintf(stderr, "Failed to write the output: %s\n", strerror(errno));
+    }
+
+    pthread_mutex_lock(&pipeline.lock);
+    pipeline.done = 1;
+    pthread_cond_broadcast(&pipeline.batch_filled);
+    pthread_mutex_unlock(&pipeline.lock);
+
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (options.verbose) {
+        struct timespec end_time;
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        double seconds = (double) (end_time.tv_sec - start_time.tv_sec) +
+                         (double) (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+        fprintf(stderr, "Solved %lu puzzles (%lu invalid) on %u threads in %.3fs, %.0f puzzles/s\n",
+                puzzle_count, invalid_count, options.thread_count, seconds,
+                seconds > 0 ? (double) puzzle_count / seconds : 0.0);
+    }
+
+    if (options.parallel) {
+        smalldoku_parallel_solver_destroy(&parallel);
+    }
+
+    free(workers);
+    free(pipeline.batches);
+
+    return status;
+}
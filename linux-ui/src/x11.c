@@ -8,9 +8,11 @@
 
 #include <smalldoku/smalldoku.h>
 #include "smalldoku-linux/smalldoku-x11.h"
+#include "smalldoku-linux/smalldoku-bank-file.h"
 
 const int32_t OUTER_PADDING = 20;
-const int32_t SCALE = 80;
+const int32_t SCALE = SMALLDOKU_CORE_GRAPHICS_CELL_SIZE;
+const uint64_t GENERATOR_STEP_WORK = 2000;
 
 static void create_window(Display **display, int *screen, Window *window, Atom *delete_window_atom) {
     *display = XOpenDisplay(NULL);
@@ -71,10 +73,6 @@ static XFontStruct *load_font(Display *display, const char *font_specification)
     return font;
 }
 
-static uint8_t generate_random_number(uint8_t min, uint8_t max) {
-    return rand() % (max + 1 - min) + min;
-}
-
 static void get_window_size(smalldoku_x11_graphics_t *graphics, smalldoku_uint32_t *width, smalldoku_uint32_t *height) {
     Window root_window;
     int32_t x_pos;
@@ -155,14 +153,35 @@ int smalldoku_run_x11(int argc, const char **argv) {
             .font = dejavu_font
     };
 
-    smalldoku_core_ui_t ui = smalldoku_core_ui_new((smalldoku_graphics_t *) &graphics, generate_random_number);
+    uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 0) : (uint64_t) time(NULL);
+    printf("Using seed %lu\n", (unsigned long) seed);
+
+    smalldoku_core_ui_t ui = smalldoku_core_ui_new((smalldoku_graphics_t *) &graphics, seed);
+
+    smalldoku_bank_file_t bank_file;
+    smalldoku_uint8_t has_bank = 0;
+
+    if (argc > 2) {
+        smalldoku_bank_status_t status = smalldoku_bank_file_open(&bank_file, argv[2]);
+
+        if (status != SMALLDOKU_BANK_OK) {
+            fprintf(stderr, "Failed to open bank %s: %s\n", argv[2], smalldoku_bank_status_name(status));
+            exit(1);
+        }
+
+        has_bank = 1;
+        smalldoku_core_ui_set_bank(&ui, &bank_file.bank);
+    }
+
     smalldoku_core_ui_begin_game(&ui);
 
     XSetFont(display, gc, dejavu_font->fid);
 
-    srand(time(NULL));
-
     while (1) {
+        if (XPending(display) == 0 && smalldoku_core_ui_generate(&ui, GENERATOR_STEP_WORK)) {
+            continue;
+        }
+
         XEvent event;
         XNextEvent(display, &event);
 
@@ -203,6 +222,10 @@ int smalldoku_run_x11(int argc, const char **argv) {
     }
 
     exit_program:
+    if (has_bank) {
+        smalldoku_bank_file_close(&bank_file);
+    }
+
     XFreeFont(display, dejavu_font);
     XUnmapWindow(display, window);
     XDestroyWindow(display, window);
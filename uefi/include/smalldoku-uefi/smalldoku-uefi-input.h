@@ -123,11 +123,13 @@ EFI_STATUS uefi_input_system_initialize(
  * @param input_system the input system to process events for
  * @param graphics the graphics system to request redraws from
  * @param ui the UI state to dispatch events to
+ * @param wait whether to wait for an event, if 0 the call returns immediately when no event is pending
  * @return EFI_SUCCESS if the handling succeeded, an error code otherwise
  */
 EFI_STATUS uefi_input_system_process_event(
         smalldoku_uefi_application_t *application,
         uefi_input_system_t *input_system,
         uefi_graphics_t *graphics,
-        smalldoku_core_ui_t *ui
+        smalldoku_core_ui_t *ui,
+        uint8_t wait
 );
@@ -3,33 +3,42 @@
 
 #include <immintrin.h>
 
+#include <smalldoku/smalldoku-memory.h>
 #include <smalldoku-core-ui/smalldoku-core-ui.h>
 
 #include "smalldoku-uefi/smalldoku-uefi.h"
 #include "smalldoku-uefi/smalldoku-uefi-graphics.h"
 #include "smalldoku-uefi/smalldoku-uefi-input.h"
 
-const uint32_t SCALE = 80;
+const uint32_t SCALE = SMALLDOKU_CORE_GRAPHICS_CELL_SIZE;
+const uint64_t GENERATOR_STEP_WORK = 2000;
 
 #define _STR_MACRO2(x) #x
 #define _STR_MACRO(x) _STR_MACRO2(x)
 
 #define INCLUDE_BINARY(type, name, path)               \
     extern type name;                                  \
+    extern char name##_end;                            \
     __asm__(""                                         \
             ".section \".rodata\", \"a\", @progbits\n" \
+            ".balign 8\n"                               \
             #name ":\n"                                \
             ".incbin \"" _STR_MACRO(path) "\"\n"       \
+            #name "_end:\n"                            \
             ".previous")
 
 INCLUDE_BINARY(uefi_graphics_psf_font_t, font_psfu, SMALLDOKU_UEFI_FONT_FILE);
 INCLUDE_BINARY(char, cursor_raw, SMALLDOKU_UEFI_CURSOR_FILE);
 
-static uint8_t generate_random_number(uint8_t min, uint8_t max) {
-    uint32_t generated_value;
-    _rdrand32_step(&generated_value); // TODO: Better RNG
+#ifdef SMALLDOKU_UEFI_BANK_FILE
+INCLUDE_BINARY(char, bank_data, SMALLDOKU_UEFI_BANK_FILE);
+#endif
 
-    return generated_value % (max + 1 - min) + min;
+static uint64_t generate_seed() {
+    unsigned long long seed = 0;
+    _rdrand64_step(&seed);
+
+    return seed;
 }
 
 static EFI_STATUS report_fatal_error(
@@ -64,6 +73,12 @@ static void redraw(uefi_graphics_t *graphics, smalldoku_core_ui_t *ui, uint32_t
 __attribute__((unused)) EFI_STATUS efi_main(EFI_HANDLE image_handle, EFI_SYSTEM_TABLE *system_table) {
     InitializeLib(image_handle, system_table);
 
+    if (smalldoku_memory_init() == SMALLDOKU_MEMORY_AVX2) {
+        Print(u"Using AVX2 memory primitives\n");
+    } else {
+        Print(u"Using SSE2 memory primitives\n");
+    }
+
     smalldoku_uefi_application_t application = {system_table, system_table->BootServices, image_handle};
 
     Print(u"Smalldoku starting!\n");
@@ -88,7 +103,21 @@ __attribute__((unused)) EFI_STATUS efi_main(EFI_HANDLE image_handle, EFI_SYSTEM_
 
     uefi_graphics_set_font(&graphics, &font_psfu, 3);
 
-    smalldoku_core_ui_t ui = smalldoku_core_ui_new((smalldoku_graphics_t *) &graphics, generate_random_number);
+    uint64_t seed = generate_seed();
+    Print(u"Using seed %lx\n", seed);
+
+    smalldoku_core_ui_t ui = smalldoku_core_ui_new((smalldoku_graphics_t *) &graphics, seed);
+
+#ifdef SMALLDOKU_UEFI_BANK_FILE
+    smalldoku_bank_t bank;
+    smalldoku_bank_status_t bank_status = smalldoku_bank_open(&bank, &bank_data, &bank_data_end - &bank_data);
+
+    if (bank_status == SMALLDOKU_BANK_OK) {
+        smalldoku_core_ui_set_bank(&ui, &bank);
+    } else {
+        Print(u"Embedded bank is invalid (%d), generating games instead\n", bank_status);
+    }
+#endif
     uefi_input_system_t input_system;
 
     EFI_STATUS status = uefi_input_system_initialize(&application, &graphics, &input_system);
@@ -104,7 +133,9 @@ __attribute__((unused)) EFI_STATUS efi_main(EFI_HANDLE image_handle, EFI_SYSTEM_
     Print(u"Initial draw done!\n");
 
     while (TRUE) {
-        status = uefi_input_system_process_event(&application, &input_system, &graphics, &ui);
+        uint8_t generating = smalldoku_core_ui_generate(&ui, GENERATOR_STEP_WORK);
+
+        status = uefi_input_system_process_event(&application, &input_system, &graphics, &ui, !generating);
         if(EFI_ERROR(status)) {
             return report_fatal_error(system_table, status, &graphics, "Failed to process events!");
         }
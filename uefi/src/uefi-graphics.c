@@ -2,6 +2,8 @@
 
 #include <efilib.h>
 
+#include <smalldoku/smalldoku-memory.h>
+
 static EFI_GUID GRAPHICS_PROTOCOL_GUID = EFI_GRAPHICS_OUTPUT_PROTOCOL_GUID;
 
 #define I_MIN(a, b) (((a) < (b)) ? (a) : (b))
@@ -33,17 +35,32 @@ static uint32_t convert_rgba_to_mode(uefi_graphics_t *graphics, uint32_t rgb) {
     }
 }
 
+/**
+ * Looks up the pixels to draw to.
+ *
+ * @param graphics the graphics context
+ * @param pixels_per_scan_line the distance between the rows of the pixels to write to
+ * @return the first pixel of the back buffer, or of the frame buffer if there is none
+ */
+static uint32_t *get_pixels(uefi_graphics_t *graphics, uint32_t *pixels_per_scan_line) {
+    if (graphics->pixel_buffer) {
+        *pixels_per_scan_line = graphics->width;
+        return graphics->pixel_buffer;
+    }
+
+    *pixels_per_scan_line = graphics->protocol->Mode->Info->PixelsPerScanLine;
+    return (uint32_t *) graphics->protocol->Mode->FrameBufferBase;
+}
+
 static void set_pixel(uefi_graphics_t *graphics, uint32_t x, uint32_t y, uint32_t native_color) {
-    if (x > graphics->width || y > graphics->height) {
+    if (x >= graphics->width || y >= graphics->height) {
         return;
     }
 
-    char *framebuffer_base = graphics->pixel_buffer ? graphics->pixel_buffer
-                                                    : (char *) graphics->protocol->Mode->FrameBufferBase;
-    uint32_t pixels_per_scan_line = graphics->pixel_buffer ? graphics->width
-                                                           : graphics->protocol->Mode->Info->PixelsPerScanLine;
+    uint32_t pixels_per_scan_line;
+    uint32_t *pixels = get_pixels(graphics, &pixels_per_scan_line);
 
-    *((uint32_t *) (framebuffer_base + 4 * pixels_per_scan_line * y + 4 * x)) = native_color;
+    pixels[pixels_per_scan_line * y + x] = native_color;
 }
 
 static void query_size(uefi_graphics_t *graphics, uint32_t *width, uint32_t *height) {
@@ -243,13 +260,24 @@ void uefi_graphics_set_fill(uefi_graphics_t *graphics, uint32_t color) {
 }
 
 void uefi_graphics_draw_rect(uefi_graphics_t *graphics, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    uint32_t color = graphics->fill_color;
-
-    for (uint32_t cx = x; cx <= x + width; cx++) {
-        for (uint32_t cy = y; cy <= y + height; cy++) {
-            set_pixel(graphics, cx, cy, color);
-        }
+    if (x >= graphics->width || y >= graphics->height) {
+        return;
     }
+
+    /* The rectangle includes its right and bottom edge, clip it to the screen and fill it row by row */
+    uint32_t columns = I_MIN(width + 1, graphics->width - x);
+    uint32_t rows = I_MIN(height + 1, graphics->height - y);
+
+    uint32_t pixels_per_scan_line;
+    uint32_t *pixels = get_pixels(graphics, &pixels_per_scan_line);
+
+    smalldoku_fill_rect32(
+            pixels + (uint64_t) pixels_per_scan_line * y + x,
+            pixels_per_scan_line,
+            columns,
+            rows,
+            graphics->fill_color
+    );
 }
 
 void uefi_graphics_draw_text(uefi_graphics_t *graphics, uint32_t x, uint32_t y, const char *text) {
@@ -218,33 +218,65 @@ EFI_STATUS uefi_input_system_initialize(
     return EFI_SUCCESS;
 }
 
-EFI_STATUS uefi_input_system_process_event(
+static EFI_STATUS poll_event(
         smalldoku_uefi_application_t *application,
         uefi_input_system_t *input_system,
-        uefi_graphics_t *graphics,
-        smalldoku_core_ui_t *ui
+        UINTN *event_index
 ) {
-    Print(u"Selecting from %d events\n", input_system->protocol_count);
-
-    for(uint32_t i = 0; i < input_system->protocol_count; i++) {
+    for (uint32_t i = 0; i < input_system->protocol_count; i++) {
         EFI_STATUS status = application->boot_services->CheckEvent(input_system->event_buffer[i]);
-        uint8_t is_valid = status == EFI_SUCCESS || status == EFI_NOT_READY;
 
-        if(!is_valid) {
-            Print(u"Event %d is invalid: %r\n", input_system->event_buffer[i], status);
+        if (status == EFI_SUCCESS) {
+            *event_index = i;
+            return EFI_SUCCESS;
+        } else if (status != EFI_NOT_READY) {
+            Print(u"CheckEvent failed: %r\n", status);
+            return status;
         }
     }
 
+    return EFI_NOT_READY;
+}
+
+EFI_STATUS uefi_input_system_process_event(
+        smalldoku_uefi_application_t *application,
+        uefi_input_system_t *input_system,
+        uefi_graphics_t *graphics,
+        smalldoku_core_ui_t *ui,
+        uint8_t wait
+) {
     UINTN event_index;
-    EFI_STATUS status = application->boot_services->WaitForEvent(
-            input_system->protocol_count,
-            input_system->event_buffer,
-            &event_index
-    );
 
-    if (EFI_ERROR(status)) {
-        Print(u"WaitForEvent failed: %r\n", status);
-        return status;
+    if (!wait) {
+        EFI_STATUS status = poll_event(application, input_system, &event_index);
+
+        if (status == EFI_NOT_READY) {
+            return EFI_SUCCESS;
+        } else if (EFI_ERROR(status)) {
+            return status;
+        }
+    } else {
+        Print(u"Selecting from %d events\n", input_system->protocol_count);
+
+        for(uint32_t i = 0; i < input_system->protocol_count; i++) {
+            EFI_STATUS status = application->boot_services->CheckEvent(input_system->event_buffer[i]);
+            uint8_t is_valid = status == EFI_SUCCESS || status == EFI_NOT_READY;
+
+            if(!is_valid) {
+                Print(u"Event %d is invalid: %r\n", input_system->event_buffer[i], status);
+            }
+        }
+
+        EFI_STATUS status = application->boot_services->WaitForEvent(
+                input_system->protocol_count,
+                input_system->event_buffer,
+                &event_index
+        );
+
+        if (EFI_ERROR(status)) {
+            Print(u"WaitForEvent failed: %r\n", status);
+            return status;
+        }
     }
 
     uefi_opened_input_protocol_t *event_protocol = &input_system->opened_protocols[event_index];